@@ -0,0 +1,59 @@
+#!/usr/bin/env bash
+# Bot load test: a local dedicated server and K headless bot clients running the bot script through the movement set.
+# The server writes tick time, bandwidth per connection and correction counts to Saved/Benchmarks as CSV and JSON.
+#
+# Usage: Scripts/RunBotLoadTest.sh [bots] [seconds] [lag ms]
+#   UE_ROOT     Engine install, defaults to ~/UnrealEngine
+#   SERVER_BIN  Packaged vznServer binary, the editor is run with -server when unset (needs a source engine build to package)
+#   CLIENT_BIN  Packaged game binary, the editor is run with -game when unset
+#   MAP         Map the server loads, defaults to the third person map
+#   PORT        Server port, defaults to 7777
+
+set -euo pipefail
+
+PROJECT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+UE_ROOT="${UE_ROOT:-$HOME/UnrealEngine}"
+EDITOR_BIN="$UE_ROOT/Engine/Binaries/Linux/UnrealEditor"
+MAP="${MAP:-/Game/ThirdPerson/Maps/ThirdPersonMap}"
+PORT="${PORT:-7777}"
+
+BOTS="${1:-8}"
+SECONDS_TO_RUN="${2:-120}"
+LAG="${3:-0}"
+
+if [[ -n "${SERVER_BIN:-}" ]]; then
+	SERVER=("$SERVER_BIN" "$MAP")
+else
+	SERVER=("$EDITOR_BIN" "$PROJECT_DIR/vzn.uproject" "$MAP" -server)
+fi
+
+if [[ -n "${CLIENT_BIN:-}" ]]; then
+	CLIENT=("$CLIENT_BIN")
+else
+	CLIENT=("$EDITOR_BIN" "$PROJECT_DIR/vzn.uproject" -game)
+fi
+
+LOG_DIR="$PROJECT_DIR/Saved/Logs/BotLoadTest"
+mkdir -p "$LOG_DIR"
+
+CLIENT_PIDS=()
+trap 'kill "${CLIENT_PIDS[@]}" 2>/dev/null || true' EXIT
+
+"${SERVER[@]}" -port="$PORT" -unattended -nosound \
+	-BotLoadTest -BotLanes="$BOTS" -BotLoadSeconds="$SECONDS_TO_RUN" \
+	-log -abslog="$LOG_DIR/Server.log" &
+SERVER_PID=$!
+
+sleep 10 # Give the server time to load the map before the bots connect
+
+for ((Bot = 0; Bot < BOTS; Bot++)); do
+	"${CLIENT[@]}" "127.0.0.1:$PORT" -nullrhi -unattended -nosound -nosplash \
+		-BotClient -BotLanes="$BOTS" -ExecCmds="NetEmulation.PktLag $LAG" \
+		-log -abslog="$LOG_DIR/Bot$Bot.log" &
+	CLIENT_PIDS+=($!)
+done
+
+# The server exits by itself once it has written the results
+wait "$SERVER_PID"
+
+ls -t "$PROJECT_DIR"/Saved/Benchmarks/BotLoadTest_* 2>/dev/null | head -n 2
@@ -0,0 +1,22 @@
+#!/usr/bin/env bash
+# Headless climb benchmark. Results land in Saved/Benchmarks as CSV (per frame) and JSON (summary per character count).
+#
+# Usage: Scripts/RunClimbBenchmark.sh [counts] [frames]
+#   UE_ROOT     Engine install, defaults to ~/UnrealEngine
+#   EDITOR_BIN  Overrides the binary, e.g. a packaged Linux game for non-editor numbers
+
+set -euo pipefail
+
+PROJECT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+UE_ROOT="${UE_ROOT:-$HOME/UnrealEngine}"
+EDITOR_BIN="${EDITOR_BIN:-$UE_ROOT/Engine/Binaries/Linux/UnrealEditor}"
+
+COUNTS="${1:-1,16,64,256}"
+FRAMES="${2:-600}"
+
+"$EDITOR_BIN" "$PROJECT_DIR/vzn.uproject" /Game/StarterContent/Maps/Minimal_Default -game \
+	-nullrhi -unattended -nosound -nosplash -benchmark -fps=60 \
+	-ClimbBenchmark -ClimbBenchmarkCounts="$COUNTS" -ClimbBenchmarkFrames="$FRAMES" \
+	-log -stdout
+
+ls -t "$PROJECT_DIR"/Saved/Benchmarks/ClimbBenchmark_* 2>/dev/null | head -n 2
@@ -0,0 +1,43 @@
+#!/usr/bin/env bash
+# Local dedicated server plus several clients on this machine, for checking climb prediction under latency.
+# Climb on any client and watch for correction boxes (p.NetShowCorrections) and the Climb Net Corrections stat.
+#
+# Usage: Scripts/RunClimbNetTest.sh [clients] [lag ms] [loss %]
+#   UE_ROOT     Engine install, defaults to ~/UnrealEngine
+#   EDITOR_BIN  Overrides the binary
+#   MAP         Map the server travels to, defaults to the third person map
+#   PORT        Server port, defaults to 7777
+
+set -euo pipefail
+
+PROJECT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+UE_ROOT="${UE_ROOT:-$HOME/UnrealEngine}"
+EDITOR_BIN="${EDITOR_BIN:-$UE_ROOT/Engine/Binaries/Linux/UnrealEditor}"
+MAP="${MAP:-/Game/ThirdPerson/Maps/ThirdPersonMap}"
+PORT="${PORT:-7777}"
+
+CLIENTS="${1:-2}"
+LAG="${2:-100}"
+LOSS="${3:-1}"
+
+LOG_DIR="$PROJECT_DIR/Saved/Logs/ClimbNetTest"
+mkdir -p "$LOG_DIR"
+
+PIDS=()
+trap 'kill "${PIDS[@]}" 2>/dev/null || true' EXIT
+
+"$EDITOR_BIN" "$PROJECT_DIR/vzn.uproject" "$MAP" -server -port="$PORT" -nosound -unattended \
+	-log -abslog="$LOG_DIR/Server.log" &
+PIDS+=($!)
+
+sleep 10 # Give the server time to load the map before the clients connect
+
+for ((Client = 0; Client < CLIENTS; Client++)); do
+	"$EDITOR_BIN" "$PROJECT_DIR/vzn.uproject" "127.0.0.1:$PORT" -game -windowed -ResX=960 -ResY=540 \
+		-WinX=$((Client * 40)) -WinY=$((Client * 40)) -nosound \
+		-ExecCmds="NetEmulation.PktLag $LAG, NetEmulation.PktLoss $LOSS, p.NetShowCorrections 1, stat Climb, stat Net" \
+		-log -abslog="$LOG_DIR/Client$Client.log" &
+	PIDS+=($!)
+done
+
+wait "${PIDS[0]}"
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Benchmark/BenchmarkSummary.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+double BenchmarkSummary::Percentile(TArray<double> InValues, double InPercentile)
+{
+	if (InValues.IsEmpty()) return 0.0;
+
+	InValues.Sort();
+	const int32 Index = FMath::Clamp(FMath::CeilToInt32(InPercentile * InValues.Num()) - 1, 0, InValues.Num() - 1);
+	return InValues[Index];
+}
+
+TSharedRef<FJsonObject> BenchmarkSummary::MakeSummary(const TArray<double>& InValues)
+{
+	TSharedRef<FJsonObject> Summary = MakeShared<FJsonObject>();
+
+	double Total = 0.0;
+	double Max = 0.0;
+
+	for (double Value : InValues)
+	{
+		Total += Value;
+		Max = FMath::Max(Max, Value);
+	}
+
+	Summary->SetNumberField(TEXT("avg"), InValues.IsEmpty() ? 0.0 : Total / InValues.Num());
+	Summary->SetNumberField(TEXT("p50"), Percentile(InValues, 0.5));
+	Summary->SetNumberField(TEXT("p95"), Percentile(InValues, 0.95));
+	Summary->SetNumberField(TEXT("max"), Max);
+
+	return Summary;
+}
+
+bool BenchmarkSummary::WriteResults(const FString& InBaseName, const FString& InCsv, const TSharedRef<FJsonObject>& InJson, FString& OutCsvPath, FString& OutJsonPath)
+{
+	const FString Directory = FPaths::ProjectSavedDir() / TEXT("Benchmarks");
+	const FString BaseName = FString::Printf(TEXT("%s_%s"), *InBaseName, *FDateTime::Now().ToString());
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(InJson, Writer);
+
+	OutCsvPath = Directory / (BaseName + TEXT(".csv"));
+	OutJsonPath = Directory / (BaseName + TEXT(".json"));
+
+	return FFileHelper::SaveStringToFile(InCsv, *OutCsvPath) && FFileHelper::SaveStringToFile(Json, *OutJsonPath);
+}
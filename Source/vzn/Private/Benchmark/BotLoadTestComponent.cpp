@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/BotLoadTestComponent.h"
+#include "Benchmark/BotLoadTestSubsystem.h"
+#include "vzn/vznCharacter.h"
+#include "Engine/World.h"
+
+UBotLoadTestComponent::UBotLoadTestComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	SetIsReplicatedByDefault(true);
+}
+
+void UBotLoadTestComponent::ServerResetBot_Implementation()
+{
+	UBotLoadTestSubsystem* BotLoadTest = GetWorld()->GetSubsystem<UBotLoadTestSubsystem>();
+	if (!BotLoadTest) return;
+
+	BotLoadTest->ResetBot(Cast<AvznCharacter>(GetOwner()));
+}
@@ -0,0 +1,389 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/BotLoadTestSubsystem.h"
+#include "Benchmark/BenchmarkSummary.h"
+#include "Benchmark/BotLoadTestComponent.h"
+#include "vzn/vznCharacter.h"
+#include "Components/CustomMovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY(LogBotLoadTest);
+
+bool UBotLoadTestSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if UE_BUILD_SHIPPING
+	return false;
+#else
+	const TCHAR* CommandLine = FCommandLine::Get();
+	const bool bRequested = FParse::Param(CommandLine, TEXT("BotLoadTest")) || FParse::Param(CommandLine, TEXT("BotClient"));
+
+	return bRequested && Super::ShouldCreateSubsystem(Outer);
+#endif
+}
+
+bool UBotLoadTestSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UBotLoadTestSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	ParseCommandLine();
+
+	const ENetMode NetMode = InWorld.GetNetMode();
+	bServer = FParse::Param(FCommandLine::Get(), TEXT("BotLoadTest")) && (NetMode == NM_DedicatedServer || NetMode == NM_ListenServer);
+	bClient = FParse::Param(FCommandLine::Get(), TEXT("BotClient")) && NetMode == NM_Client;
+
+	// Nothing to do in the world a client loads before it connects
+	if (!bServer && !bClient) return;
+
+	if (bServer)
+	{
+		WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UBotLoadTestSubsystem::OnWorldTickStart);
+	}
+
+	Course.bWithProps = true;
+	Course.Build(&InWorld, NumLanes, CourseActors);
+
+	if (bClient)
+	{
+		Script = FClimbMovementScript::MakeBotLoop();
+	}
+
+	UE_LOG(LogBotLoadTest, Log, TEXT("Built %d bot lanes as the %s"), NumLanes, bServer ? TEXT("server") : TEXT("client"));
+}
+
+void UBotLoadTestSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+
+	CourseActors.Empty();
+	BotLanes.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UBotLoadTestSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBotLoadTestSubsystem, STATGROUP_Tickables);
+}
+
+void UBotLoadTestSubsystem::ParseCommandLine()
+{
+	FParse::Value(FCommandLine::Get(), TEXT("BotLanes="), NumLanes);
+	FParse::Value(FCommandLine::Get(), TEXT("BotLoadSeconds="), LoadSeconds);
+	FParse::Value(FCommandLine::Get(), TEXT("BotLoadWarmup="), WarmupSeconds);
+
+	NumLanes = FMath::Max(NumLanes, 1);
+	LoadSeconds = FMath::Max(LoadSeconds, SampleInterval);
+	WarmupSeconds = FMath::Max(WarmupSeconds, 0.f);
+}
+
+void UBotLoadTestSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (bFinished) return;
+
+	if (bServer)
+	{
+		TickServer(DeltaTime);
+	}
+	else if (bClient)
+	{
+		TickClient(DeltaTime);
+	}
+}
+
+#pragma region Server
+
+void UBotLoadTestSubsystem::TickServer(float DeltaTime)
+{
+	AssignLanes();
+
+	if (BotLanes.IsEmpty()) return;
+
+	const double PreviousRunTime = RunTime;
+	RunTime += DeltaTime;
+
+	if (RunTime < WarmupSeconds) return;
+
+	// Corrections from bots settling in don't count
+	if (PreviousRunTime < WarmupSeconds)
+	{
+		ResetCorrectionBaselines();
+	}
+
+	RecordFrame(DeltaTime);
+
+	if (RunTime >= WarmupSeconds + SampleInterval * (ServerSamples.Num() + 1))
+	{
+		TakeSample();
+	}
+
+	if (RunTime >= WarmupSeconds + LoadSeconds)
+	{
+		bFinished = true;
+		WriteResults();
+
+		if (!GIsEditor)
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+	}
+}
+
+void UBotLoadTestSubsystem::AssignLanes()
+{
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* Controller = It->Get();
+		AvznCharacter* Character = Controller ? Cast<AvznCharacter>(Controller->GetPawn()) : nullptr;
+		if (!Character) continue;
+
+		// Carries the bot's reset requests, replicated to its client, added again to a respawned pawn
+		if (!Character->FindComponentByClass<UBotLoadTestComponent>())
+		{
+			UBotLoadTestComponent* BotLoadTestComponent = NewObject<UBotLoadTestComponent>(Character);
+			BotLoadTestComponent->RegisterComponent();
+		}
+
+		const bool bAssigned = BotLanes.ContainsByPredicate([Controller](const FBotLane& InBotLane) { return InBotLane.Controller.Get() == Controller; });
+		if (bAssigned) continue;
+
+		if (BotLanes.Num() >= NumLanes)
+		{
+			UE_LOG(LogBotLoadTest, Warning, TEXT("No lane left for %s, raise -BotLanes on the server and the clients"), *GetNameSafe(Controller));
+			continue;
+		}
+
+		FBotLane& BotLane = BotLanes.AddDefaulted_GetRef();
+		BotLane.Controller = Controller;
+		BotLane.Lane = BotLanes.Num() - 1;
+
+		ResetBot(Character);
+		BotLane.Resets = 0; // Placing a new bot isn't a reset
+
+		UE_LOG(LogBotLoadTest, Log, TEXT("%s joined on lane %d"), *GetNameSafe(Controller), BotLane.Lane);
+	}
+}
+
+void UBotLoadTestSubsystem::ResetBot(AvznCharacter* InCharacter)
+{
+	if (!bServer || !InCharacter) return;
+
+	AController* Controller = InCharacter->GetController();
+	if (!Controller) return;
+
+	FBotLane* BotLane = BotLanes.FindByPredicate([Controller](const FBotLane& InBotLane) { return InBotLane.Controller.Get() == Controller; });
+	if (!BotLane) return;
+
+	BotLane->Resets++;
+
+	// The default capsule, the current one is shorter while climbing
+	const float HalfHeight = InCharacter->GetClass()->GetDefaultObject<AvznCharacter>()->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+	InCharacter->ScriptedReset(Course.GetLaneStartTransform(BotLane->Lane, HalfHeight));
+	Controller->SetControlRotation(FRotator::ZeroRotator);
+}
+
+void UBotLoadTestSubsystem::ResetCorrectionBaselines()
+{
+	for (FBotLane& BotLane : BotLanes)
+	{
+		const APlayerController* Controller = BotLane.Controller.Get();
+		const AvznCharacter* Character = Controller ? Cast<AvznCharacter>(Controller->GetPawn()) : nullptr;
+		const UCustomMovementComponent* MovementComponent = Character ? Character->GetCustomMovementComponent() : nullptr;
+
+		BotLane.LastCorrections = MovementComponent ? MovementComponent->GetServerCorrections() : 0;
+		BotLane.LastResets = BotLane.Resets;
+	}
+
+	IntervalFrames = 0;
+	IntervalFrameMs = IntervalFrameMsMax = 0.0;
+	IntervalWorldTickMs = IntervalWorldTickMsMax = 0.0;
+}
+
+void UBotLoadTestSubsystem::RecordFrame(float DeltaTime)
+{
+	const double FrameMs = DeltaTime * 1000.0;
+
+	// From the start of this world tick, GGameThreadTime still holds the previous frame here
+	const double WorldTickMs = WorldTickStartCycles ? FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - WorldTickStartCycles) : 0.0;
+
+	IntervalFrames++;
+	IntervalFrameMs += FrameMs;
+	IntervalFrameMsMax = FMath::Max(IntervalFrameMsMax, FrameMs);
+	IntervalWorldTickMs += WorldTickMs;
+	IntervalWorldTickMsMax = FMath::Max(IntervalWorldTickMsMax, WorldTickMs);
+}
+
+void UBotLoadTestSubsystem::OnWorldTickStart(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds)
+{
+	if (InWorld != GetWorld()) return;
+
+	WorldTickStartCycles = FPlatformTime::Cycles64();
+}
+
+void UBotLoadTestSubsystem::TakeSample()
+{
+	FBotLoadServerSample& Sample = ServerSamples.AddDefaulted_GetRef();
+	Sample.Time = RunTime - WarmupSeconds;
+	Sample.FrameMsAvg = IntervalFrames > 0 ? IntervalFrameMs / IntervalFrames : 0.0;
+	Sample.FrameMsMax = IntervalFrameMsMax;
+	Sample.WorldTickMsAvg = IntervalFrames > 0 ? IntervalWorldTickMs / IntervalFrames : 0.0;
+	Sample.WorldTickMsMax = IntervalWorldTickMsMax;
+
+	if (const UNetDriver* NetDriver = GetWorld()->GetNetDriver())
+	{
+		Sample.InBytesPerSecond = int32(NetDriver->InBytesPerSecond);
+		Sample.OutBytesPerSecond = int32(NetDriver->OutBytesPerSecond);
+	}
+
+	for (FBotLane& BotLane : BotLanes)
+	{
+		const APlayerController* Controller = BotLane.Controller.Get();
+		const UNetConnection* Connection = Controller ? Controller->GetNetConnection() : nullptr;
+		if (!Connection) continue; // Left, or the listen server's own player
+
+		const AvznCharacter* Character = Cast<AvznCharacter>(Controller->GetPawn());
+		const UCustomMovementComponent* MovementComponent = Character ? Character->GetCustomMovementComponent() : nullptr;
+		const uint32 Corrections = MovementComponent ? MovementComponent->GetServerCorrections() : BotLane.LastCorrections;
+
+		FBotLoadConnectionSample& ConnectionSample = ConnectionSamples.AddDefaulted_GetRef();
+		ConnectionSample.SampleIndex = ServerSamples.Num() - 1;
+		ConnectionSample.Lane = BotLane.Lane;
+		ConnectionSample.InBytesPerSecond = Connection->InBytesPerSecond;
+		ConnectionSample.OutBytesPerSecond = Connection->OutBytesPerSecond;
+		ConnectionSample.PingMs = Controller->PlayerState ? Controller->PlayerState->GetPingInMilliseconds() : 0.f;
+		ConnectionSample.Corrections = Corrections >= BotLane.LastCorrections ? Corrections - BotLane.LastCorrections : Corrections; // A respawned pawn counts from zero
+		ConnectionSample.Resets = BotLane.Resets - BotLane.LastResets;
+
+		BotLane.LastCorrections = Corrections;
+		BotLane.LastResets = BotLane.Resets;
+
+		Sample.NumConnections++;
+		Sample.Corrections += ConnectionSample.Corrections;
+	}
+
+	IntervalFrames = 0;
+	IntervalFrameMs = IntervalFrameMsMax = 0.0;
+	IntervalWorldTickMs = IntervalWorldTickMsMax = 0.0;
+}
+
+#pragma endregion
+
+#pragma region Client
+
+void UBotLoadTestSubsystem::TickClient(float DeltaTime)
+{
+	const APlayerController* Controller = GetWorld()->GetFirstPlayerController();
+	AvznCharacter* Character = Controller ? Cast<AvznCharacter>(Controller->GetPawn()) : nullptr;
+	if (!Character) return;
+
+	// Resets go through the component the server adds, wait for it to replicate
+	if (!Character->FindComponentByClass<UBotLoadTestComponent>()) return;
+
+	if (Character != LocalBot.Get())
+	{
+		LocalBot = Character;
+
+		// Not rendered with -nullrhi, the mesh still has to pose for the root motion montages
+		Character->GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+
+		// The server knows our lane, the script waits for its teleport to arrive
+		Character->ScriptedReset(FTransform::Identity);
+		ScriptPlayer.Start(Script, FTransform::Identity, 0.f);
+		ClientStartTime = ClientStartDelay;
+		return;
+	}
+
+	if (ClientStartTime > 0.f)
+	{
+		ClientStartTime -= DeltaTime;
+		return;
+	}
+
+	// Inputs for next frame
+	ScriptPlayer.Tick(Character, Script, DeltaTime);
+}
+
+#pragma endregion
+
+#pragma region Output
+
+void UBotLoadTestSubsystem::WriteResults() const
+{
+	FString Csv = TEXT("Time,Connections,FrameMsAvg,FrameMsMax,WorldTickMsAvg,WorldTickMsMax,ServerInBytesPerSec,ServerOutBytesPerSec,Lane,InBytesPerSec,OutBytesPerSec,PingMs,Corrections,Resets\n");
+
+	TArray<double> FrameMs, WorldTickMs, WorldTickMsMax, InBytes, OutBytes, PingMs, CorrectionsPerSecond;
+	uint32 TotalCorrections = 0;
+	uint32 TotalResets = 0;
+
+	for (const FBotLoadServerSample& Sample : ServerSamples)
+	{
+		FrameMs.Add(Sample.FrameMsAvg);
+		WorldTickMs.Add(Sample.WorldTickMsAvg);
+		WorldTickMsMax.Add(Sample.WorldTickMsMax);
+	}
+
+	for (const FBotLoadConnectionSample& ConnectionSample : ConnectionSamples)
+	{
+		const FBotLoadServerSample& Sample = ServerSamples[ConnectionSample.SampleIndex];
+
+		Csv += FString::Printf(TEXT("%.2f,%d,%.4f,%.4f,%.4f,%.4f,%d,%d,%d,%d,%d,%.1f,%u,%u\n"),
+			Sample.Time, Sample.NumConnections, Sample.FrameMsAvg, Sample.FrameMsMax, Sample.WorldTickMsAvg, Sample.WorldTickMsMax,
+			Sample.InBytesPerSecond, Sample.OutBytesPerSecond, ConnectionSample.Lane, ConnectionSample.InBytesPerSecond, ConnectionSample.OutBytesPerSecond,
+			ConnectionSample.PingMs, ConnectionSample.Corrections, ConnectionSample.Resets);
+
+		InBytes.Add(ConnectionSample.InBytesPerSecond);
+		OutBytes.Add(ConnectionSample.OutBytesPerSecond);
+		PingMs.Add(ConnectionSample.PingMs);
+
+		// A reset teleports the bot, so the server corrects it once for each
+		const uint32 Corrections = ConnectionSample.Corrections - FMath::Min(ConnectionSample.Corrections, ConnectionSample.Resets);
+		CorrectionsPerSecond.Add(Corrections / SampleInterval);
+
+		TotalCorrections += Corrections;
+		TotalResets += ConnectionSample.Resets;
+	}
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("map"), GetWorld()->GetMapName());
+	Root->SetNumberField(TEXT("bots"), BotLanes.Num());
+	Root->SetNumberField(TEXT("warmupSeconds"), WarmupSeconds);
+	Root->SetNumberField(TEXT("seconds"), ServerSamples.Num() * SampleInterval);
+	Root->SetObjectField(TEXT("serverFrameMs"), BenchmarkSummary::MakeSummary(FrameMs));
+	Root->SetObjectField(TEXT("serverWorldTickMs"), BenchmarkSummary::MakeSummary(WorldTickMs));
+	Root->SetObjectField(TEXT("serverWorldTickMsMax"), BenchmarkSummary::MakeSummary(WorldTickMsMax));
+	Root->SetObjectField(TEXT("inBytesPerSecondPerConnection"), BenchmarkSummary::MakeSummary(InBytes));
+	Root->SetObjectField(TEXT("outBytesPerSecondPerConnection"), BenchmarkSummary::MakeSummary(OutBytes));
+	Root->SetObjectField(TEXT("pingMs"), BenchmarkSummary::MakeSummary(PingMs));
+	Root->SetObjectField(TEXT("correctionsPerSecondPerConnection"), BenchmarkSummary::MakeSummary(CorrectionsPerSecond));
+	Root->SetNumberField(TEXT("corrections"), TotalCorrections); // Excluding resets
+	Root->SetNumberField(TEXT("resets"), TotalResets);
+
+	FString CsvPath, JsonPath;
+
+	if (BenchmarkSummary::WriteResults(TEXT("BotLoadTest"), Csv, Root, CsvPath, JsonPath))
+	{
+		UE_LOG(LogBotLoadTest, Display, TEXT("Wrote %s and %s"), *CsvPath, *JsonPath);
+	}
+	else
+	{
+		UE_LOG(LogBotLoadTest, Error, TEXT("Failed to write results to %s"), *FPaths::GetPath(CsvPath));
+	}
+}
+
+#pragma endregion
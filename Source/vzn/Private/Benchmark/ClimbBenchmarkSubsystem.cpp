@@ -0,0 +1,330 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/ClimbBenchmarkSubsystem.h"
+#include "vzn/vznCharacter.h"
+#include "Components/CustomMovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Benchmark/BenchmarkSummary.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+
+DEFINE_LOG_CATEGORY(LogClimbBenchmark);
+
+bool UClimbBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("ClimbBenchmark")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UClimbBenchmarkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UClimbBenchmarkSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	ParseCommandLine();
+
+	CharacterClass = LoadClass<AvznCharacter>(nullptr, *CharacterClassPath);
+
+	if (!CharacterClass)
+	{
+		UE_LOG(LogClimbBenchmark, Warning, TEXT("Couldn't load %s, spawning the native character without animation or input assets"), *CharacterClassPath);
+		CharacterClass = AvznCharacter::StaticClass();
+	}
+
+	if (CharacterCounts.IsEmpty())
+	{
+		UE_LOG(LogClimbBenchmark, Error, TEXT("No character counts to run"));
+		bFinished = true;
+		return;
+	}
+
+	Script = FClimbMovementScript::MakeCourseLoop();
+
+	WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UClimbBenchmarkSubsystem::OnWorldTickStart);
+
+	Course.Build(GetWorld(), FMath::Max(CharacterCounts), CourseActors);
+	UE_LOG(LogClimbBenchmark, Log, TEXT("Built %d course lanes"), FMath::Max(CharacterCounts));
+	StartRun(0);
+}
+
+void UClimbBenchmarkSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+
+	DestroyCharacters();
+	CourseActors.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UClimbBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UClimbBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+void UClimbBenchmarkSubsystem::ParseCommandLine()
+{
+	FString CountsString;
+	if (FParse::Value(FCommandLine::Get(), TEXT("ClimbBenchmarkCounts="), CountsString))
+	{
+		TArray<FString> CountStrings;
+		CountsString.ParseIntoArray(CountStrings, TEXT(","));
+
+		CharacterCounts.Reset();
+		for (const FString& CountString : CountStrings)
+		{
+			const int32 Count = FCString::Atoi(*CountString);
+			if (Count > 0)
+			{
+				CharacterCounts.Add(Count);
+			}
+		}
+	}
+
+	FParse::Value(FCommandLine::Get(), TEXT("ClimbBenchmarkFrames="), MeasuredFrames);
+	FParse::Value(FCommandLine::Get(), TEXT("ClimbBenchmarkWarmup="), WarmupFrames);
+	FParse::Value(FCommandLine::Get(), TEXT("ClimbBenchmarkCharacter="), CharacterClassPath);
+
+	MeasuredFrames = FMath::Max(MeasuredFrames, 1);
+	WarmupFrames = FMath::Max(WarmupFrames, 0);
+}
+
+#pragma region Course
+
+FTransform UClimbBenchmarkSubsystem::GetLaneStartTransform(int32 InLane) const
+{
+	const float HalfHeight = CharacterClass ? CharacterClass->GetDefaultObject<AvznCharacter>()->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() : 96.f;
+
+	return Course.GetLaneStartTransform(InLane, HalfHeight);
+}
+
+#pragma endregion
+
+#pragma region Run
+
+void UClimbBenchmarkSubsystem::StartRun(int32 InCountIndex)
+{
+	CountIndex = InCountIndex;
+	RunFrame = 0;
+	LastTraceHeapAllocations = 0; // Fresh characters, their counters start at zero
+
+	SpawnCharacters(CharacterCounts[CountIndex]);
+
+	UE_LOG(LogClimbBenchmark, Log, TEXT("Running %d characters"), CharacterCounts[CountIndex]);
+}
+
+void UClimbBenchmarkSubsystem::EndRun()
+{
+	DestroyCharacters();
+
+	if (CountIndex + 1 < CharacterCounts.Num())
+	{
+		StartRun(CountIndex + 1);
+		return;
+	}
+
+	bFinished = true;
+	WriteResults();
+
+	if (!GIsEditor)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void UClimbBenchmarkSubsystem::SpawnCharacters(int32 InNumCharacters)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	Characters.Reserve(InNumCharacters);
+	ScriptPlayers.SetNum(InNumCharacters);
+
+	for (int32 Index = 0; Index < InNumCharacters; Index++)
+	{
+		const FTransform StartTransform = GetLaneStartTransform(Index);
+
+		AvznCharacter* Character = GetWorld()->SpawnActor<AvznCharacter>(CharacterClass, StartTransform, SpawnParams);
+		if (!Character) continue;
+
+		// No controllers here, movement has to run anyway and the mesh has to pose without being rendered for root motion
+		if (UCustomMovementComponent* MovementComponent = Character->GetCustomMovementComponent())
+		{
+			MovementComponent->bRunPhysicsWithNoController = true;
+		}
+		Character->GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+
+		ScriptPlayers[Characters.Num()].Start(Script, StartTransform, Index * ScriptStagger);
+		Characters.Add(Character);
+	}
+
+	ScriptPlayers.SetNum(Characters.Num());
+}
+
+void UClimbBenchmarkSubsystem::DestroyCharacters()
+{
+	for (AvznCharacter* Character : Characters)
+	{
+		if (Character)
+		{
+			Character->Destroy();
+		}
+	}
+
+	Characters.Reset();
+	ScriptPlayers.Reset();
+}
+
+void UClimbBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (bFinished || CountIndex == INDEX_NONE) return;
+
+	// Ticks after the characters, so this frame's movement is already done when it's recorded
+	if (RunFrame >= WarmupFrames)
+	{
+		RecordFrame(DeltaTime);
+	}
+	else
+	{
+		LastTraceHeapAllocations = SumTraceHeapAllocations();
+	}
+
+	// Inputs for next frame
+	for (int32 Index = 0; Index < Characters.Num(); Index++)
+	{
+		ScriptPlayers[Index].Tick(Characters[Index], Script, DeltaTime);
+	}
+
+	if (++RunFrame >= WarmupFrames + MeasuredFrames)
+	{
+		EndRun();
+	}
+}
+
+void UClimbBenchmarkSubsystem::RecordFrame(float DeltaTime)
+{
+	FClimbBenchmarkFrame& Frame = Frames.AddDefaulted_GetRef();
+	Frame.NumCharacters = Characters.Num();
+	Frame.FrameMs = DeltaTime * 1000.0;
+
+	// GGameThreadTime is only published at the end of the frame, time this frame's world tick up to here instead
+	Frame.WorldTickMs = WorldTickStartCycles ? FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - WorldTickStartCycles) : 0.0;
+
+	double PhysClimbSeconds = 0.0;
+
+	for (const AvznCharacter* Character : Characters)
+	{
+		const UCustomMovementComponent* MovementComponent = Character ? Character->GetCustomMovementComponent() : nullptr;
+		if (!MovementComponent) continue;
+
+		PhysClimbSeconds += MovementComponent->GetPhysClimbSecondsThisFrame();
+		Frame.SceneQueries += MovementComponent->GetClimbSceneQueriesThisFrame();
+		Frame.ComponentMoves += MovementComponent->GetClimbComponentMovesThisFrame();
+
+		if (MovementComponent->IsClimbing())
+		{
+			Frame.NumClimbing++;
+		}
+	}
+
+	Frame.PhysClimbMs = PhysClimbSeconds * 1000.0;
+
+	const uint64 TraceHeapAllocations = SumTraceHeapAllocations();
+	Frame.TraceHeapAllocations = static_cast<uint32>(TraceHeapAllocations - LastTraceHeapAllocations);
+	LastTraceHeapAllocations = TraceHeapAllocations;
+}
+
+uint64 UClimbBenchmarkSubsystem::SumTraceHeapAllocations() const
+{
+	uint64 TraceHeapAllocations = 0;
+
+	for (const AvznCharacter* Character : Characters)
+	{
+		if (const UCustomMovementComponent* MovementComponent = Character ? Character->GetCustomMovementComponent() : nullptr)
+		{
+			TraceHeapAllocations += MovementComponent->GetClimbTraceHeapAllocations();
+		}
+	}
+
+	return TraceHeapAllocations;
+}
+
+void UClimbBenchmarkSubsystem::OnWorldTickStart(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds)
+{
+	if (InWorld != GetWorld()) return;
+
+	WorldTickStartCycles = FPlatformTime::Cycles64();
+}
+
+#pragma endregion
+
+#pragma region Output
+
+void UClimbBenchmarkSubsystem::WriteResults() const
+{
+	FString Csv = TEXT("Characters,Frame,FrameMs,WorldTickMs,PhysClimbMs,SceneQueries,ComponentMoves,TraceHeapAllocations,Climbing\n");
+
+	TArray<TSharedPtr<FJsonValue>> RunValues;
+	int32 FrameIndex = 0;
+
+	for (int32 RunCount : CharacterCounts)
+	{
+		TArray<double> FrameMs, WorldTickMs, PhysClimbMs, SceneQueries, ComponentMoves, TraceHeapAllocations;
+		int32 NumCharacters = 0;
+
+		for (int32 RunFrameIndex = 0; RunFrameIndex < MeasuredFrames && FrameIndex < Frames.Num(); RunFrameIndex++, FrameIndex++)
+		{
+			const FClimbBenchmarkFrame& Frame = Frames[FrameIndex];
+
+			Csv += FString::Printf(TEXT("%d,%d,%.4f,%.4f,%.4f,%u,%u,%u,%d\n"),
+				Frame.NumCharacters, RunFrameIndex, Frame.FrameMs, Frame.WorldTickMs, Frame.PhysClimbMs, Frame.SceneQueries, Frame.ComponentMoves, Frame.TraceHeapAllocations, Frame.NumClimbing);
+
+			NumCharacters = Frame.NumCharacters;
+			FrameMs.Add(Frame.FrameMs);
+			WorldTickMs.Add(Frame.WorldTickMs);
+			PhysClimbMs.Add(Frame.PhysClimbMs);
+			SceneQueries.Add(Frame.SceneQueries);
+			ComponentMoves.Add(Frame.ComponentMoves);
+			TraceHeapAllocations.Add(Frame.TraceHeapAllocations);
+		}
+
+		TSharedRef<FJsonObject> Run = MakeShared<FJsonObject>();
+		Run->SetNumberField(TEXT("requestedCharacters"), RunCount);
+		Run->SetNumberField(TEXT("characters"), NumCharacters); // Lower than requested if spawns failed
+		Run->SetNumberField(TEXT("frames"), FrameMs.Num());
+		Run->SetObjectField(TEXT("frameMs"), BenchmarkSummary::MakeSummary(FrameMs));
+		Run->SetObjectField(TEXT("worldTickMs"), BenchmarkSummary::MakeSummary(WorldTickMs));
+		Run->SetObjectField(TEXT("physClimbMs"), BenchmarkSummary::MakeSummary(PhysClimbMs));
+		Run->SetObjectField(TEXT("sceneQueries"), BenchmarkSummary::MakeSummary(SceneQueries));
+		Run->SetObjectField(TEXT("componentMoves"), BenchmarkSummary::MakeSummary(ComponentMoves));
+		Run->SetObjectField(TEXT("traceHeapAllocations"), BenchmarkSummary::MakeSummary(TraceHeapAllocations));
+
+		RunValues.Add(MakeShared<FJsonValueObject>(Run));
+	}
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("map"), GetWorld()->GetMapName());
+	Root->SetStringField(TEXT("character"), GetNameSafe(CharacterClass));
+	Root->SetNumberField(TEXT("warmupFrames"), WarmupFrames);
+	Root->SetArrayField(TEXT("runs"), RunValues);
+
+	FString CsvPath, JsonPath;
+
+	if (BenchmarkSummary::WriteResults(TEXT("ClimbBenchmark"), Csv, Root, CsvPath, JsonPath))
+	{
+		UE_LOG(LogClimbBenchmark, Display, TEXT("Wrote %s and %s"), *CsvPath, *JsonPath);
+	}
+	else
+	{
+		UE_LOG(LogClimbBenchmark, Error, TEXT("Failed to write results to %s"), *FPaths::GetPath(CsvPath));
+	}
+}
+
+#pragma endregion
@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Benchmark/ClimbCourse.h"
+#include "Engine/World.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/StaticMesh.h"
+#include "Components/StaticMeshComponent.h"
+#include "LaunchPad.h"
+#include "Switch.h"
+#include "MovingPlatform.h"
+#include "Components/GrappleTargetComponent.h"
+
+namespace ClimbCourse
+{
+	// Engine cube is 100 units on a side
+	static const TCHAR* CubeMeshPath = TEXT("/Engine/BasicShapes/Cube.Cube");
+
+	static constexpr float RunUpLength = 1500.f; // Props run-up in front of the lane, along -X
+}
+
+template<typename ActorType>
+ActorType* FClimbCourse::SpawnProp(UWorld* InWorld, const FString& InClassPath, const FVector& InLocation, TFunctionRef<void(ActorType*)> InSetup) const
+{
+	UClass* PropClass = LoadClass<ActorType>(nullptr, *InClassPath);
+
+	if (!PropClass)
+	{
+		// The native classes have no meshes or materials, but still trigger
+		PropClass = ActorType::StaticClass();
+	}
+
+	const FTransform PropTransform(FQuat::Identity, InLocation);
+
+	ActorType* Prop = InWorld->SpawnActorDeferred<ActorType>(PropClass, PropTransform);
+	if (!Prop) return nullptr;
+
+	// Built locally on every machine, a replicated copy from the server would be a duplicate
+	Prop->SetReplicates(false);
+	InSetup(Prop);
+	Prop->FinishSpawning(PropTransform);
+
+	return Prop;
+}
+
+// Each lane runs along +X: floor, a low block to vault, a climbable wall with a walkable top and a grapple target past it
+void FClimbCourse::Build(UWorld* InWorld, int32 InNumLanes, TArray<TObjectPtr<AActor>>& OutActors) const
+{
+	if (!InWorld) return;
+
+	for (int32 Lane = 0; Lane < InNumLanes; Lane++)
+	{
+		const FVector LaneOrigin = Origin + FVector(0.f, Lane * LaneSpacing, 0.f);
+
+		OutActors.Add(SpawnBlock(InWorld, LaneOrigin + FVector(1500.f, 0.f, -50.f), FVector(3400.f, LaneSpacing, 100.f))); // Floor
+		OutActors.Add(SpawnBlock(InWorld, LaneOrigin + FVector(700.f, 0.f, 50.f), FVector(60.f, 200.f, 100.f))); // Vault block
+		OutActors.Add(SpawnBlock(InWorld, LaneOrigin + FVector(1500.f, 0.f, 300.f), FVector(400.f, 300.f, 600.f))); // Wall
+
+		if (AActor* GrappleTarget = SpawnBlock(InWorld, LaneOrigin + FVector(2500.f, 0.f, 900.f), FVector(50.f, 50.f, 50.f)))
+		{
+			// Interact aims at registered anchors
+			UGrappleTargetComponent* Anchor = NewObject<UGrappleTargetComponent>(GrappleTarget);
+			Anchor->SetupAttachment(GrappleTarget->GetRootComponent());
+			Anchor->RegisterComponent();
+			OutActors.Add(GrappleTarget);
+		}
+
+		if (bWithProps)
+		{
+			BuildProps(InWorld, LaneOrigin, OutActors);
+		}
+	}
+
+	OutActors.Remove(nullptr);
+}
+
+// Run-up along -X from the lane: a launch pad to jump from, a switch to interact with and the platform it starts moving
+void FClimbCourse::BuildProps(UWorld* InWorld, const FVector& InLaneOrigin, TArray<TObjectPtr<AActor>>& OutActors) const
+{
+	const float FloorCenter = -200.f - ClimbCourse::RunUpLength * 0.5f;
+	OutActors.Add(SpawnBlock(InWorld, InLaneOrigin + FVector(FloorCenter, 0.f, -50.f), FVector(ClimbCourse::RunUpLength, LaneSpacing, 100.f)));
+
+	OutActors.Add(SpawnProp<ALaunchPad>(InWorld, LaunchPadClassPath, InLaneOrigin + FVector(-1300.f, 0.f, 0.f), [](ALaunchPad*) {}));
+
+	AMovingPlatform* Platform = SpawnProp<AMovingPlatform>(InWorld, MovingPlatformClassPath, InLaneOrigin + FVector(-400.f, 0.f, 0.f), [](AMovingPlatform* InPlatform)
+	{
+		InPlatform->PathPoints = { FVector(0.f, 0.f, 40.f) }; // Below the step height, so it can be walked onto at either end
+	});
+	OutActors.Add(Platform);
+
+	// The switch registers its own interact target
+	OutActors.Add(SpawnProp<ASwitch>(InWorld, SwitchClassPath, InLaneOrigin + FVector(-700.f, 0.f, 100.f), [Platform](ASwitch* InSwitch)
+	{
+		InSwitch->ConnectedPlatform = Platform;
+	}));
+}
+
+AActor* FClimbCourse::SpawnBlock(UWorld* InWorld, const FVector& InCenter, const FVector& InSize) const
+{
+	UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, ClimbCourse::CubeMeshPath);
+	if (!CubeMesh) return nullptr;
+
+	const FTransform BlockTransform(FQuat::Identity, InCenter, InSize / 100.f);
+
+	// Deferred so the mesh is set before the static component registers
+	AStaticMeshActor* Block = InWorld->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), BlockTransform);
+	if (!Block) return nullptr;
+
+	Block->SetReplicates(false);
+	Block->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+	Block->FinishSpawning(BlockTransform);
+
+	return Block;
+}
+
+FTransform FClimbCourse::GetLaneStartTransform(int32 InLane, float InCapsuleHalfHeight) const
+{
+	const float StartX = bWithProps ? -100.f - ClimbCourse::RunUpLength : 100.f;
+
+	return FTransform(FQuat::Identity, Origin + FVector(StartX, InLane * LaneSpacing, InCapsuleHalfHeight + 2.f));
+}
@@ -0,0 +1,186 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/ClimbMathBenchmarkCommandlet.h"
+#include "Components/ClimbMath.h"
+#include "Misc/FileHelper.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogClimbMathBenchmark, Log, All);
+
+namespace ClimbMathBenchmark
+{
+	// Distinct inputs per iteration so the kernels can't be hoisted out of the loop
+	static constexpr int32 NumCases = 256;
+
+	struct FCase
+	{
+		FClimbSurfaceSamples Samples;
+		FVector ComponentLocation;
+		FVector ComponentForward;
+		FQuat ComponentQuat;
+	};
+
+	// Wall facing -X at a random distance in front of the character, with some noise on the hits like a real capsule trace
+	static void MakeCase(FRandomStream& InStream, int32 InNumSamples, FCase& OutCase)
+	{
+		OutCase.ComponentLocation = InStream.GetUnitVector() * 1000.f;
+		OutCase.ComponentForward = FVector(1.f, InStream.FRandRange(-0.2f, 0.2f), 0.f).GetSafeNormal();
+		OutCase.ComponentQuat = OutCase.ComponentForward.ToOrientationQuat();
+
+		const FVector WallNormal = FVector(-1.f, InStream.FRandRange(-0.3f, 0.3f), InStream.FRandRange(-0.3f, 0.3f)).GetSafeNormal();
+		const FVector WallPoint = OutCase.ComponentLocation + FVector(InStream.FRandRange(30.f, 60.f), 0.f, 0.f);
+
+		FVector AxisU, AxisV;
+		WallNormal.FindBestAxisVectors(AxisU, AxisV);
+
+		OutCase.Samples.Reset(OutCase.ComponentLocation);
+
+		for (int32 Index = 0; Index < InNumSamples; Index++)
+		{
+			const FVector Point = WallPoint + AxisU * InStream.FRandRange(-40.f, 40.f) + AxisV * InStream.FRandRange(-90.f, 90.f) + WallNormal * InStream.FRandRange(-1.f, 1.f);
+			const FVector Normal = (WallNormal + InStream.GetUnitVector() * 0.05f).GetSafeNormal();
+
+			OutCase.Samples.Add(Point, Normal, Index);
+		}
+	}
+
+	struct FResult
+	{
+		FString Name;
+		double NanosecondsPerCall = 0.0;
+	};
+
+	template<typename FunctionType>
+	static FResult Run(const TCHAR* InName, int32 InIterations, const TArray<FCase>& InCases, FunctionType&& InFunction)
+	{
+		double Sink = 0.0;
+
+		// Warm the caches and branch predictors before timing
+		for (int32 Index = 0; Index < NumCases; Index++)
+		{
+			Sink += InFunction(InCases[Index]);
+		}
+
+		const double StartSeconds = FPlatformTime::Seconds();
+
+		for (int32 Iteration = 0; Iteration < InIterations; Iteration++)
+		{
+			Sink += InFunction(InCases[Iteration & (NumCases - 1)]);
+		}
+
+		const double ElapsedSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+		// Keeps the results observable so the loop isn't optimised away
+		UE_LOG(LogClimbMathBenchmark, Verbose, TEXT("%s sink %f"), InName, Sink);
+
+		return { InName, ElapsedSeconds * 1e9 / InIterations };
+	}
+}
+
+UClimbMathBenchmarkCommandlet::UClimbMathBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UClimbMathBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace ClimbMathBenchmark;
+
+	int32 Iterations = 200000;
+	int32 NumSamples = 8;
+	int32 Seed = 1234;
+	FString CsvPath;
+
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	FParse::Value(*Params, TEXT("Samples="), NumSamples);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Csv="), CsvPath);
+
+	Iterations = FMath::Max(Iterations, 1);
+	NumSamples = FMath::Clamp(NumSamples, 1, FClimbSurfaceSamples::Capacity);
+
+	FRandomStream Stream(Seed);
+
+	TArray<FCase> Cases;
+	Cases.SetNum(NumCases);
+
+	for (FCase& Case : Cases)
+	{
+		MakeCase(Stream, NumSamples, Case);
+	}
+
+	const FClimbPlaneFitSettings PlaneFitSettings;
+	const ClimbMath::FVaultPattern VaultPattern;
+	const float MaxClimbableSurfaceCos = FMath::Cos(FMath::DegreesToRadians(60.f));
+	const float DeltaTime = 1.f / 60.f;
+
+	TArray<FResult> Results;
+
+	Results.Add(Run(TEXT("ResolveSurface.Average"), Iterations, Cases, [&](const FCase& Case)
+	{
+		FVector Location, Normal;
+		ClimbMath::ResolveSurface(Case.Samples, false, Case.ComponentLocation, PlaneFitSettings, Location, Normal);
+		return Location.X + Normal.X;
+	}));
+
+	Results.Add(Run(TEXT("ResolveSurface.PlaneFit"), Iterations, Cases, [&](const FCase& Case)
+	{
+		FVector Location, Normal;
+		ClimbMath::ResolveSurface(Case.Samples, true, Case.ComponentLocation, PlaneFitSettings, Location, Normal);
+		return Location.X + Normal.X;
+	}));
+
+	Results.Add(Run(TEXT("IsWalkableNormal"), Iterations, Cases, [&](const FCase& Case)
+	{
+		return ClimbMath::IsWalkableNormal(Case.Samples.GetNormal(0), FVector::UpVector, MaxClimbableSurfaceCos) ? 1.0 : 0.0;
+	}));
+
+	Results.Add(Run(TEXT("AnyNormalParallelTo"), Iterations, Cases, [&](const FCase& Case)
+	{
+		return Case.Samples.AnyNormalParallelTo(FVector::UpVector) ? 1.0 : 0.0;
+	}));
+
+	Results.Add(Run(TEXT("GetSnapDelta"), Iterations, Cases, [&](const FCase& Case)
+	{
+		const FVector SurfaceLocation = Case.Samples.GetPoint(0);
+		return ClimbMath::GetSnapDelta(SurfaceLocation, Case.Samples.GetNormal(0), Case.ComponentLocation, Case.ComponentForward, DeltaTime, 100.f).X;
+	}));
+
+	Results.Add(Run(TEXT("InterpClimbRotation"), Iterations, Cases, [&](const FCase& Case)
+	{
+		return ClimbMath::InterpClimbRotation(Case.ComponentQuat, Case.Samples.GetNormal(0), DeltaTime, 5.f).X;
+	}));
+
+	Results.Add(Run(TEXT("GetVaultSample"), Iterations, Cases, [&](const FCase& Case)
+	{
+		double Sum = 0.0;
+
+		for (int32 Index = 0; Index < 5; Index++)
+		{
+			FVector Start, End;
+			ClimbMath::GetVaultSample(Case.ComponentLocation, Case.ComponentForward, FVector::UpVector, VaultPattern, Index, Start, End);
+			Sum += Start.X + End.Z;
+		}
+
+		return Sum;
+	}));
+
+	FString Csv = TEXT("Kernel,Samples,Iterations,NsPerCall\n");
+
+	for (const FResult& Result : Results)
+	{
+		UE_LOG(LogClimbMathBenchmark, Display, TEXT("%-28s %10.2f ns"), *Result.Name, Result.NanosecondsPerCall);
+		Csv += FString::Printf(TEXT("%s,%d,%d,%.3f\n"), *Result.Name, NumSamples, Iterations, Result.NanosecondsPerCall);
+	}
+
+	if (!CsvPath.IsEmpty() && !FFileHelper::SaveStringToFile(Csv, *CsvPath))
+	{
+		UE_LOG(LogClimbMathBenchmark, Error, TEXT("Failed to write %s"), *CsvPath);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Benchmark/ClimbMovementScript.h"
+#include "vzn/vznCharacter.h"
+
+float FClimbMovementScript::GetTotalDuration() const
+{
+	float TotalDuration = 0.f;
+
+	for (const FClimbScriptStep& Step : Steps)
+	{
+		TotalDuration += Step.Duration;
+	}
+
+	return TotalDuration;
+}
+
+FClimbMovementScript FClimbMovementScript::MakeCourseLoop()
+{
+	const FVector2D Forward(0.f, 1.f);
+
+	FClimbMovementScript Script;
+	Script.Steps =
+	{
+		{ EClimbScriptAction::None,				Forward,				0.5f }, // Run up to walking speed
+		{ EClimbScriptAction::CrouchPressed,	Forward,				0.3f }, // Slide
+		{ EClimbScriptAction::CrouchReleased,	Forward,				0.1f },
+		{ EClimbScriptAction::Climb,			Forward,				1.2f }, // Vault the low block
+		{ EClimbScriptAction::None,				Forward,				0.6f }, // Run to the wall
+		{ EClimbScriptAction::Climb,			FVector2D::ZeroVector,	1.2f }, // Start climbing
+		{ EClimbScriptAction::None,				Forward,				1.0f }, // Climb up
+		{ EClimbScriptAction::Hop,				Forward,				1.0f },
+		{ EClimbScriptAction::None,				Forward,				3.0f }, // Climb until the ledge mantle
+		{ EClimbScriptAction::None,				Forward,				0.5f }, // Walk along the top
+		{ EClimbScriptAction::InteractPressed,	FVector2D::ZeroVector,	1.5f }, // Grapple to the target
+		{ EClimbScriptAction::InteractReleased,	FVector2D::ZeroVector,	1.0f },
+		{ EClimbScriptAction::Reset,			FVector2D::ZeroVector,	0.1f }
+	};
+
+	return Script;
+}
+
+FClimbMovementScript FClimbMovementScript::MakeBotLoop()
+{
+	const FVector2D Forward(0.f, 1.f);
+
+	FClimbMovementScript Script;
+	Script.Steps =
+	{
+		{ EClimbScriptAction::None,				Forward,				0.5f }, // Run onto the launch pad
+		{ EClimbScriptAction::JumpPressed,		Forward,				0.2f },
+		{ EClimbScriptAction::JumpReleased,		Forward,				1.0f }, // Land short of the switch
+		{ EClimbScriptAction::InteractPressed,	FVector2D::ZeroVector,	0.3f }, // Switch starts the platform
+		{ EClimbScriptAction::InteractReleased,	Forward,				1.0f }  // Over the platform and into the lane
+	};
+
+	Script.Steps.Append(MakeCourseLoop().Steps);
+
+	return Script;
+}
+
+void FClimbMovementScriptPlayer::Start(const FClimbMovementScript& InScript, const FTransform& InStartTransform, float InTimeOffset)
+{
+	StartTransform = InStartTransform;
+	StepIndex = INDEX_NONE;
+	StepTime = 0.f;
+
+	if (InScript.Steps.IsEmpty()) return;
+
+	// Skip ahead so characters sharing a script don't all do the same thing on the same frame
+	float TimeOffset = FMath::Fmod(InTimeOffset, InScript.GetTotalDuration());
+	StepIndex = 0;
+
+	while (TimeOffset > InScript.Steps[StepIndex].Duration)
+	{
+		TimeOffset -= InScript.Steps[StepIndex].Duration;
+		StepIndex = (StepIndex + 1) % InScript.Steps.Num();
+	}
+
+	StepTime = TimeOffset;
+}
+
+void FClimbMovementScriptPlayer::Tick(AvznCharacter* InCharacter, const FClimbMovementScript& InScript, float DeltaTime)
+{
+	if (!InCharacter || StepIndex == INDEX_NONE) return;
+
+	StepTime += DeltaTime;
+
+	while (StepTime >= InScript.Steps[StepIndex].Duration)
+	{
+		StepTime -= InScript.Steps[StepIndex].Duration;
+		StepIndex = (StepIndex + 1) % InScript.Steps.Num();
+
+		RunAction(InCharacter, InScript.Steps[StepIndex].Action);
+	}
+
+	const FClimbScriptStep& Step = InScript.Steps[StepIndex];
+
+	if (!Step.MoveInput.IsZero())
+	{
+		InCharacter->ScriptedMove(Step.MoveInput);
+	}
+}
+
+void FClimbMovementScriptPlayer::RunAction(AvznCharacter* InCharacter, EClimbScriptAction::Type InAction) const
+{
+	switch (InAction)
+	{
+	case EClimbScriptAction::Climb:
+		InCharacter->ScriptedClimb();
+		break;
+
+	case EClimbScriptAction::Hop:
+		InCharacter->ScriptedHop();
+		break;
+
+	case EClimbScriptAction::CrouchPressed:
+		InCharacter->ScriptedCrouch(true);
+		break;
+
+	case EClimbScriptAction::CrouchReleased:
+		InCharacter->ScriptedCrouch(false);
+		break;
+
+	case EClimbScriptAction::InteractPressed:
+		InCharacter->ScriptedInteract(true);
+		break;
+
+	case EClimbScriptAction::InteractReleased:
+		InCharacter->ScriptedInteract(false);
+		break;
+
+	case EClimbScriptAction::JumpPressed:
+		InCharacter->ScriptedJump(true);
+		break;
+
+	case EClimbScriptAction::JumpReleased:
+		InCharacter->ScriptedJump(false);
+		break;
+
+	case EClimbScriptAction::Reset:
+		InCharacter->ScriptedReset(StartTransform);
+		break;
+
+	default:
+		break;
+	}
+}
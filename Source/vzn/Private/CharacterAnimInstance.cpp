@@ -4,7 +4,6 @@
 #include "CharacterAnimInstance.h"
 #include "vzn/vznCharacter.h"
 #include "Components/CustomMovementComponent.h"
-#include "Kismet/KismetMathLibrary.h"
 
 void UCharacterAnimInstance::NativeInitializeAnimation()
 {
@@ -25,45 +24,53 @@ void UCharacterAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
 	// Return early if the character or movement component is not valid
 	if (!vznCharacter || !CustomMovementComponent) return;
 
-	// Get the properties for the anim blueprint
+	// One copy per update, nothing after this reads the character or its movement component
+	MovementSnapshot = CustomMovementComponent->GetMovementSnapshot();
+}
+
+void UCharacterAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaSeconds)
+{
+	Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
+
+	// Get the properties for the anim blueprint, falling first since whether to move depends on it
 	GetGroundSpeed();
 	GetAirSpeed();
-	GetShouldMove();
 	GetIsFalling();
+	GetShouldMove();
 	GetIsClimbing();
 	GetClimbVelocity();
 }
 
 void UCharacterAnimInstance::GetGroundSpeed() 
 {
-	GroundSpeed = UKismetMathLibrary::VSizeXY(vznCharacter->GetVelocity()); // Gets the horizontal velocity 
+	GroundSpeed = MovementSnapshot.Velocity.Size2D(); // Gets the horizontal velocity 
 }
 
 void UCharacterAnimInstance::GetAirSpeed()
 {
-	AirSpeed = vznCharacter->GetVelocity().Z; // Gets the vertical speed
+	AirSpeed = MovementSnapshot.Velocity.Z; // Gets the vertical speed
 }
 
 void UCharacterAnimInstance::GetShouldMove()
 {
 	// The character should move based on acceleration and ground speed, and if they're not falling
 	bShouldMove =
-		CustomMovementComponent->GetCurrentAcceleration().Size() > 0 &&
+		MovementSnapshot.bHasAcceleration &&
 		GroundSpeed > 5.f &&
 		!bIsFalling;
 }
 
 void UCharacterAnimInstance::GetIsFalling()
 {
-	bIsFalling = CustomMovementComponent->IsFalling(); // Check if the character is falling
+	bIsFalling = MovementSnapshot.bIsFalling; // Check if the character is falling
 }
 
 void UCharacterAnimInstance::GetIsClimbing()
 {
-	bIsClimbing = CustomMovementComponent->IsClimbing(); // Check if the character is climbing
+	bIsClimbing = MovementSnapshot.bIsClimbing; // Check if the character is climbing
 }
 
 void UCharacterAnimInstance::GetClimbVelocity()
 {
-	ClimbVelocity = CustomMovementComponent->GetUnrotatedClimbVelocity(); // Get the climb velocity
+	ClimbVelocity = MovementSnapshot.UnrotatedClimbVelocity; // Get the climb velocity
 }
\ No newline at end of file
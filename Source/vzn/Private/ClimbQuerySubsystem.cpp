@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbQuerySubsystem.h"
+#include "Components/CustomMovementComponent.h"
+#include "Components/ClimbStats.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Batched Climb Queries"), STAT_ClimbBatchedQueries, STATGROUP_Climb);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Climbers Batched"), STAT_ClimbersBatched, STATGROUP_Climb);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Climbers Throttled"), STAT_ClimbersThrottled, STATGROUP_Climb);
+
+static TAutoConsoleVariable<int32> CVarClimbQueryBudget(
+	TEXT("climb.QueryBudget"),
+	512,
+	TEXT("Scene queries the batched climb queries may issue per frame. The local player is never throttled."));
+
+static TAutoConsoleVariable<int32> CVarClimbQueryMaxStaleFrames(
+	TEXT("climb.QueryMaxStaleFrames"),
+	4,
+	TEXT("Frames a throttled climber can go without fresh results before it gets them regardless of the budget."));
+
+static TAutoConsoleVariable<float> CVarClimbQueryMaxStaleDistance(
+	TEXT("climb.QueryMaxStaleDistance"),
+	20.f,
+	TEXT("Distance a throttled climber can move from where its results were taken before it gets fresh ones regardless of the budget."));
+
+static TAutoConsoleVariable<float> CVarClimbQueryVisibleTime(
+	TEXT("climb.QueryVisibleTime"),
+	0.2f,
+	TEXT("A climber rendered within this many seconds counts as visible for the query priority."));
+
+void FClimbBatchedQuery::Execute(const UWorld* InWorld)
+{
+	// Only reads the scene, it isn't modified until the actors tick
+	SurfaceHits.Reset();
+	InWorld->SweepMultiByObjectType(SurfaceHits, SurfaceStart, SurfaceEnd, FQuat::Identity, *ObjectQueryParams, Capsule, *QueryParams);
+
+	FloorHits.Reset();
+	InWorld->SweepMultiByObjectType(FloorHits, FloorStart, FloorEnd, FQuat::Identity, *ObjectQueryParams, Capsule, *QueryParams);
+
+	LedgeHit = FHitResult(LedgeStart, LedgeEnd);
+	InWorld->LineTraceSingleByObjectType(LedgeHit, LedgeStart, LedgeEnd, *ObjectQueryParams, *QueryParams);
+
+	LedgeWalkableHit = FHitResult(LedgeEnd, LedgeWalkableEnd);
+	InWorld->LineTraceSingleByObjectType(LedgeWalkableHit, LedgeEnd, LedgeWalkableEnd, *ObjectQueryParams, *QueryParams);
+}
+
+void UClimbQuerySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UClimbQuerySubsystem::OnWorldPreActorTick);
+}
+
+void UClimbQuerySubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+
+	Components.Empty();
+	Batch.Empty();
+
+	Super::Deinitialize();
+}
+
+void UClimbQuerySubsystem::RegisterComponent(UCustomMovementComponent* InComponent)
+{
+	if (!InComponent) return;
+
+	Components.AddUnique(InComponent);
+}
+
+void UClimbQuerySubsystem::UnregisterComponent(UCustomMovementComponent* InComponent)
+{
+	Components.RemoveSwap(InComponent);
+}
+
+EClimbQueryPriority::Type UClimbQuerySubsystem::GetPriority(const UCustomMovementComponent* InComponent) const
+{
+	const APawn* Pawn = Cast<APawn>(InComponent->GetOwner());
+	if (!Pawn) return EClimbQueryPriority::OffScreen;
+
+	// A remote player's climb on the server has to trace what its client traced, or the moves diverge into corrections
+	if (Pawn->IsPlayerControlled() && (Pawn->IsLocallyControlled() || Pawn->HasAuthority()))
+	{
+		return EClimbQueryPriority::LocalPlayer;
+	}
+
+	if (Pawn->WasRecentlyRendered(CVarClimbQueryVisibleTime.GetValueOnGameThread()))
+	{
+		return EClimbQueryPriority::Visible;
+	}
+
+	return EClimbQueryPriority::OffScreen;
+}
+
+void UClimbQuerySubsystem::OnWorldPreActorTick(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds)
+{
+	if (InWorld != GetWorld() || InTickType == LEVELTICK_TimeOnly) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_ClimbBatchedQueries);
+
+	// Gather everyone that is climbing and not covered by a baked index
+	int32 NumQueries = 0;
+
+	for (UCustomMovementComponent* Component : Components)
+	{
+		if (!Component) continue;
+
+		if (NumQueries == Batch.Num())
+		{
+			Batch.AddDefaulted();
+		}
+
+		FClimbBatchedQuery& Query = Batch[NumQueries];
+
+		if (!Component->PrepareBatchedClimbQuery(Query, InDeltaSeconds)) continue;
+
+		Query.Component = Component;
+		Query.Priority = GetPriority(Component);
+
+		// Results too old or too far away to stand in for a trace, these go through whatever the budget says
+		if (Query.StaleFrames >= uint64(CVarClimbQueryMaxStaleFrames.GetValueOnGameThread()) ||
+			Query.StaleDistance > CVarClimbQueryMaxStaleDistance.GetValueOnGameThread())
+		{
+			Query.Priority = FMath::Min(Query.Priority, EClimbQueryPriority::Starved);
+		}
+
+		NumQueries++;
+	}
+
+	NumBatchedLastFrame = 0;
+	NumThrottledLastFrame = 0;
+
+	if (NumQueries == 0) return;
+
+	// Highest priority first, then whoever has waited longest for fresh results
+	BatchOrder.Reset();
+
+	for (int32 Index = 0; Index < NumQueries; Index++)
+	{
+		BatchOrder.Add(Index);
+	}
+
+	BatchOrder.Sort([this](int32 A, int32 B)
+	{
+		const FClimbBatchedQuery& QueryA = Batch[A];
+		const FClimbBatchedQuery& QueryB = Batch[B];
+
+		if (QueryA.Priority != QueryB.Priority) return QueryA.Priority < QueryB.Priority;
+		return QueryA.StaleFrames > QueryB.StaleFrames;
+	});
+
+	const int32 QueryBudget = CVarClimbQueryBudget.GetValueOnGameThread();
+	int32 NumBatched = 0;
+
+	for (; NumBatched < NumQueries; NumBatched++)
+	{
+		const bool bNeverThrottled = Batch[BatchOrder[NumBatched]].Priority <= EClimbQueryPriority::Starved;
+		const bool bWithinBudget = (NumBatched + 1) * FClimbBatchedQuery::NumSceneQueries <= QueryBudget;
+
+		if (!bNeverThrottled && !bWithinBudget) break;
+	}
+
+	const UWorld* World = InWorld;
+
+	ParallelFor(NumBatched, [this, World](int32 OrderIndex)
+	{
+		Batch[BatchOrder[OrderIndex]].Execute(World);
+	});
+
+	// Results go back on the game thread, before any of the components tick
+	for (int32 OrderIndex = 0; OrderIndex < NumQueries; OrderIndex++)
+	{
+		FClimbBatchedQuery& Query = Batch[BatchOrder[OrderIndex]];
+
+		if (OrderIndex < NumBatched)
+		{
+			Query.Component->ApplyBatchedClimbQuery(Query);
+		}
+		else
+		{
+			Query.Component->ThrottleClimbQueries();
+		}
+
+		Query.Component = nullptr;
+	}
+
+	NumBatchedLastFrame = NumBatched;
+	NumThrottledLastFrame = NumQueries - NumBatched;
+
+	INC_DWORD_STAT_BY(STAT_ClimbersBatched, NumBatchedLastFrame);
+	INC_DWORD_STAT_BY(STAT_ClimbersThrottled, NumThrottledLastFrame);
+}
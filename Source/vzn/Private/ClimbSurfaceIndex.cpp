@@ -0,0 +1,297 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ClimbSurfaceIndex.h"
+#include "Algo/BinarySearch.h"
+
+namespace ClimbSurfaceIndex
+{
+	// Lexicographic order for the sorted cell list
+	static bool CellCoordLess(const FIntVector& A, const FIntVector& B)
+	{
+		if (A.X != B.X) return A.X < B.X;
+		if (A.Y != B.Y) return A.Y < B.Y;
+		return A.Z < B.Z;
+	}
+
+	static FVector ClosestPointOnSegment(const FVector& InPoint, const FVector& InStart, const FVector& InEnd)
+	{
+		return FMath::ClosestPointOnSegment(InPoint, InStart, InEnd);
+	}
+}
+
+FVector FClimbSurfaceQuad::GetClosestPoint(const FVector& InPoint) const
+{
+	const FVector ToPoint = InPoint - Center;
+	const FVector U = FVector(AxisU);
+	const FVector V = FVector(AxisV);
+
+	const double ExtentU = HalfExtents.X;
+	const double ExtentV = HalfExtents.Y;
+
+	const double DistU = FMath::Clamp(FVector::DotProduct(ToPoint, U), -ExtentU, ExtentU);
+	const double DistV = FMath::Clamp(FVector::DotProduct(ToPoint, V), -ExtentV, ExtentV);
+
+	return Center + U * DistU + V * DistV;
+}
+
+FBox FClimbSurfaceQuad::GetBounds() const
+{
+	const FVector ExtentU = FVector(AxisU) * HalfExtents.X;
+	const FVector ExtentV = FVector(AxisV) * HalfExtents.Y;
+	const FVector Extent = ExtentU.GetAbs() + ExtentV.GetAbs();
+
+	return FBox(Center - Extent, Center + Extent);
+}
+
+FVector FClimbSurfaceTriangle::GetClosestPoint(const FVector& InPoint) const
+{
+	return FMath::ClosestPointOnTriangleToPoint(InPoint, A, B, C);
+}
+
+bool FClimbSurfaceTriangle::ContainsPlanePoint(const FVector& InPoint) const
+{
+	const FVector Barycentric = FMath::ComputeBaryCentric2D(InPoint, A, B, C);
+
+	// A little slack so a ray through the shared edge of two triangles hits one of them
+	static constexpr double EdgeTolerance = -1e-4;
+	return Barycentric.X >= EdgeTolerance && Barycentric.Y >= EdgeTolerance && Barycentric.Z >= EdgeTolerance;
+}
+
+FBox FClimbSurfaceTriangle::GetBounds() const
+{
+	return FBox(A.ComponentMin(B).ComponentMin(C), A.ComponentMax(B).ComponentMax(C));
+}
+
+bool FClimbSurfaceIndex::Covers(const FBox& InBox) const
+{
+	if (!Bounds.IsValid || !Bounds.IsInside(InBox)) return false;
+
+	for (const FBox& Unbaked : UnbakedBounds)
+	{
+		if (Unbaked.Intersect(InBox)) return false;
+	}
+
+	return true;
+}
+
+FIntVector FClimbSurfaceIndex::GetCellCoord(const FVector& InLocation) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(InLocation.X / CellSize),
+		FMath::FloorToInt32(InLocation.Y / CellSize),
+		FMath::FloorToInt32(InLocation.Z / CellSize));
+}
+
+const FClimbSurfaceIndexCell* FClimbSurfaceIndex::FindCell(const FIntVector& InCoord) const
+{
+	const int32 CellIndex = Algo::BinarySearchBy(Cells, InCoord, &FClimbSurfaceIndexCell::Coord, &ClimbSurfaceIndex::CellCoordLess);
+
+	return CellIndex != INDEX_NONE ? &Cells[CellIndex] : nullptr;
+}
+
+FIntVector FClimbSurfaceIndex::GetHopCellCoord(const FVector& InWallPoint, const FVector& InWallNormal) const
+{
+	const FVector KeyPoint = InWallPoint + InWallNormal * (HopCellSize * 0.5f);
+
+	return FIntVector(
+		FMath::FloorToInt32(KeyPoint.X / HopCellSize),
+		FMath::FloorToInt32(KeyPoint.Y / HopCellSize),
+		FMath::FloorToInt32(KeyPoint.Z / HopCellSize));
+}
+
+const FClimbHopCell* FClimbSurfaceIndex::FindHopCell(const FVector& InWallPoint, const FVector& InWallNormal) const
+{
+	const FClimbHopCell* HopCell = HopCells.Find(GetHopCellCoord(InWallPoint, InWallNormal));
+	if (!HopCell) return nullptr;
+
+	// Corners share cells between walls, only trust the entry for the wall it was baked from
+	if (FVector::DotProduct(FVector(HopCell->WallNormal), InWallNormal) < 0.9f) return nullptr;
+
+	return HopCell;
+}
+
+bool FClimbSurfaceIndex::HasHopCellsFor(float InEyeHeight, float InWallStandOff) const
+{
+	if (HopCells.IsEmpty()) return false;
+
+	// Probe offsets are absolute, a centimeter either way still lands on the same geometry
+	return FMath::IsNearlyEqual(HopEyeHeight, InEyeHeight, 1.f) && FMath::IsNearlyEqual(HopWallStandOff, InWallStandOff, 1.f);
+}
+
+template<typename AllocatorType>
+void FClimbSurfaceIndex::GatherItems(const FBox& InBox, TArray<int32, AllocatorType>& OutItems) const
+{
+	const FIntVector MinCell = GetCellCoord(InBox.Min);
+	const FIntVector MaxCell = GetCellCoord(InBox.Max);
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+			{
+				const FClimbSurfaceIndexCell* Cell = FindCell(FIntVector(X, Y, Z));
+				if (!Cell) continue;
+
+				for (int32 i = 0; i < Cell->NumItems; i++)
+				{
+					OutItems.AddUnique(CellItems[Cell->FirstItem + i]);
+				}
+			}
+		}
+	}
+}
+
+bool FClimbSurfaceIndex::OverlapCapsule(const FVector& InCenter, float InRadius, float InHalfHeight, FClimbSurfaceSamples& OutSamples) const
+{
+	OutSamples.Reset(InCenter);
+
+	// Vertical capsule, same as the FQuat::Identity sweeps it replaces
+	const FVector AxisOffset = FVector::UpVector * FMath::Max(InHalfHeight - InRadius, 0.f);
+	const FVector SegmentStart = InCenter - AxisOffset;
+	const FVector SegmentEnd = InCenter + AxisOffset;
+
+	const FBox QueryBox = FBox(SegmentStart, SegmentEnd).ExpandBy(InRadius);
+
+	TArray<int32, TInlineAllocator<32>> Candidates;
+	GatherItems(QueryBox, Candidates);
+
+	const double RadiusSquared = FMath::Square(InRadius);
+
+	// Closest points between the capsule axis and a face, alternating projections converge in a couple of steps for convex shapes
+	auto OverlapFace = [&](const FVector& InFacePoint, const FVector& InNormal, auto&& GetClosestFacePoint)
+	{
+		FVector AxisPoint = ClimbSurfaceIndex::ClosestPointOnSegment(InFacePoint, SegmentStart, SegmentEnd);
+		FVector FacePoint = GetClosestFacePoint(AxisPoint);
+
+		for (int32 Step = 0; Step < 3; Step++)
+		{
+			AxisPoint = ClimbSurfaceIndex::ClosestPointOnSegment(FacePoint, SegmentStart, SegmentEnd);
+			FacePoint = GetClosestFacePoint(AxisPoint);
+		}
+
+		if (FVector::DistSquared(AxisPoint, FacePoint) > RadiusSquared) return true;
+		if (FVector::DotProduct(AxisPoint - InFacePoint, InNormal) <= 0.f) return true; // Back faces are inside the collision
+
+		return OutSamples.Add(FacePoint, InNormal, 0);
+	};
+
+	for (const int32 Item : Candidates)
+	{
+		bool bRoomForMore;
+
+		if (Item < Quads.Num())
+		{
+			const FClimbSurfaceQuad& Quad = Quads[Item];
+			bRoomForMore = OverlapFace(Quad.Center, FVector(Quad.Normal), [&Quad](const FVector& InPoint) { return Quad.GetClosestPoint(InPoint); });
+		}
+		else
+		{
+			const FClimbSurfaceTriangle& Triangle = Triangles[Item - Quads.Num()];
+			bRoomForMore = OverlapFace((Triangle.A + Triangle.B + Triangle.C) / 3.0, FVector(Triangle.Normal), [&Triangle](const FVector& InPoint) { return Triangle.GetClosestPoint(InPoint); });
+		}
+
+		if (!bRoomForMore) break;
+	}
+
+	return !OutSamples.IsEmpty();
+}
+
+bool FClimbSurfaceIndex::Raycast(const FVector& InStart, const FVector& InEnd, FHitResult& OutHit) const
+{
+	OutHit = FHitResult(InStart, InEnd);
+
+	const FVector Delta = InEnd - InStart;
+
+	TArray<int32, TInlineAllocator<32>> Candidates;
+	GatherItems(FBox(InStart.ComponentMin(InEnd), InStart.ComponentMax(InEnd)), Candidates);
+
+	for (const int32 Item : Candidates)
+	{
+		const bool bQuad = Item < Quads.Num();
+		const FVector Normal = bQuad ? FVector(Quads[Item].Normal) : FVector(Triangles[Item - Quads.Num()].Normal);
+		const FVector PlanePoint = bQuad ? Quads[Item].Center : Triangles[Item - Quads.Num()].A;
+
+		const double Denominator = FVector::DotProduct(Delta, Normal);
+		if (Denominator >= -UE_KINDA_SMALL_NUMBER) continue; // Parallel or hitting the back face
+
+		const double Time = FVector::DotProduct(PlanePoint - InStart, Normal) / Denominator;
+		if (Time < 0.0 || Time > OutHit.Time) continue;
+
+		const FVector Point = InStart + Delta * Time;
+
+		if (bQuad)
+		{
+			const FClimbSurfaceQuad& Quad = Quads[Item];
+			const FVector ToPoint = Point - Quad.Center;
+
+			if (FMath::Abs(FVector::DotProduct(ToPoint, FVector(Quad.AxisU))) > Quad.HalfExtents.X) continue;
+			if (FMath::Abs(FVector::DotProduct(ToPoint, FVector(Quad.AxisV))) > Quad.HalfExtents.Y) continue;
+		}
+		else if (!Triangles[Item - Quads.Num()].ContainsPlanePoint(Point))
+		{
+			continue;
+		}
+
+		OutHit.bBlockingHit = true;
+		OutHit.Time = static_cast<float>(Time);
+		OutHit.Distance = static_cast<float>(Delta.Size() * Time);
+		OutHit.Location = Point;
+		OutHit.ImpactPoint = Point;
+		OutHit.Normal = Normal;
+		OutHit.ImpactNormal = Normal;
+		OutHit.Item = Item;
+	}
+
+	return OutHit.bBlockingHit;
+}
+
+void FClimbSurfaceIndex::BuildCells(float InCellSize)
+{
+	CellSize = FMath::Max(InCellSize, 1.f);
+	Cells.Reset();
+	CellItems.Reset();
+
+	TMap<FIntVector, TArray<int32>> ItemsByCell;
+
+	for (int32 QuadIndex = 0; QuadIndex < Quads.Num(); QuadIndex++)
+	{
+		AddItemToCells(Quads[QuadIndex].GetBounds(), QuadIndex, ItemsByCell);
+	}
+
+	for (int32 TriangleIndex = 0; TriangleIndex < Triangles.Num(); TriangleIndex++)
+	{
+		AddItemToCells(Triangles[TriangleIndex].GetBounds(), Quads.Num() + TriangleIndex, ItemsByCell);
+	}
+
+	ItemsByCell.KeySort(&ClimbSurfaceIndex::CellCoordLess);
+
+	Cells.Reserve(ItemsByCell.Num());
+
+	for (const TPair<FIntVector, TArray<int32>>& Pair : ItemsByCell)
+	{
+		FClimbSurfaceIndexCell& Cell = Cells.AddDefaulted_GetRef();
+		Cell.Coord = Pair.Key;
+		Cell.FirstItem = CellItems.Num();
+		Cell.NumItems = Pair.Value.Num();
+
+		CellItems.Append(Pair.Value);
+	}
+}
+
+void FClimbSurfaceIndex::AddItemToCells(const FBox& InItemBounds, int32 InItem, TMap<FIntVector, TArray<int32>>& InOutItemsByCell) const
+{
+	const FIntVector MinCell = GetCellCoord(InItemBounds.Min);
+	const FIntVector MaxCell = GetCellCoord(InItemBounds.Max);
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+			{
+				InOutItemsByCell.FindOrAdd(FIntVector(X, Y, Z)).Add(InItem);
+			}
+		}
+	}
+}
@@ -0,0 +1,455 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbSurfaceIndexActor.h"
+#include "ClimbSurfaceIndexSubsystem.h"
+#include "Components/BoxComponent.h"
+
+#if WITH_EDITOR
+#include "EngineUtils.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "GameFramework/Character.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/ClimbMath.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogClimbSurfaceIndex, Log, All);
+#endif
+
+// Sets default values
+AClimbSurfaceIndexActor::AClimbSurfaceIndexActor()
+{
+	// The index is only read, never updated at runtime
+	PrimaryActorTick.bCanEverTick = false;
+
+	BakeBounds = CreateDefaultSubobject<UBoxComponent>(TEXT("Bake Bounds"));
+	BakeBounds->SetBoxExtent(FVector(2000.f));
+	BakeBounds->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	RootComponent = BakeBounds;
+
+	ClimbableSurfaceTraceTypes.Add(UEngineTypes::ConvertToObjectType(ECC_WorldStatic));
+}
+
+// Called when the game starts or when spawned
+void AClimbSurfaceIndexActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (Index.IsEmpty()) return;
+
+	if (UClimbSurfaceIndexSubsystem* IndexSubsystem = GetWorld()->GetSubsystem<UClimbSurfaceIndexSubsystem>())
+	{
+		IndexSubsystem->RegisterIndex(this);
+	}
+}
+
+void AClimbSurfaceIndexActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UClimbSurfaceIndexSubsystem* IndexSubsystem = GetWorld()->GetSubsystem<UClimbSurfaceIndexSubsystem>())
+	{
+		IndexSubsystem->UnregisterIndex(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+TArray<ECollisionChannel, TInlineAllocator<4>> AClimbSurfaceIndexActor::GetClimbableChannels() const
+{
+	TArray<ECollisionChannel, TInlineAllocator<4>> ClimbableChannels;
+
+	for (const TEnumAsByte<EObjectTypeQuery>& ObjectType : ClimbableSurfaceTraceTypes)
+	{
+		ClimbableChannels.Add(UEngineTypes::ConvertToCollisionChannel(ObjectType));
+	}
+
+	return ClimbableChannels;
+}
+
+#if WITH_EDITOR
+void AClimbSurfaceIndexActor::Bake()
+{
+	UWorld* World = GetWorld();
+	if (!World) return;
+
+	Modify();
+
+	Index = FClimbSurfaceIndex();
+	Index.Bounds = BakeBounds->Bounds.GetBox();
+
+	const TArray<ECollisionChannel, TInlineAllocator<4>> ClimbableChannels = GetClimbableChannels();
+
+	const float WalkableCos = FMath::Cos(FMath::DegreesToRadians(MaxWalkableAngle));
+
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		TInlineComponentArray<UPrimitiveComponent*> Primitives(*It);
+
+		for (const UPrimitiveComponent* Primitive : Primitives)
+		{
+			// Movable collision is traced live, static and stationary collision never moves so it all belongs in the index
+			if (Primitive->Mobility == EComponentMobility::Movable) continue;
+			if (!Primitive->IsQueryCollisionEnabled()) continue;
+			if (!ClimbableChannels.Contains(Primitive->GetCollisionObjectType())) continue;
+			if (!Index.Bounds.Intersect(Primitive->Bounds.GetBox())) continue;
+
+			const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Primitive);
+			const UBodySetup* BodySetup = MeshComponent ? MeshComponent->GetBodySetup() : nullptr;
+
+			// Landscape, BSP, complex collision and round shapes, queries near them skip the index and trace everything live
+			if (!CanBakeBodySetup(BodySetup))
+			{
+				Index.UnbakedBounds.Add(Primitive->Bounds.GetBox());
+				continue;
+			}
+
+			if (const UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(MeshComponent))
+			{
+				for (int32 Instance = 0; Instance < InstancedComponent->GetInstanceCount(); Instance++)
+				{
+					FTransform InstanceTransform;
+					if (InstancedComponent->GetInstanceTransform(Instance, InstanceTransform, true))
+					{
+						AddBodySetup(*BodySetup, InstanceTransform, WalkableCos);
+					}
+				}
+			}
+			else
+			{
+				AddBodySetup(*BodySetup, MeshComponent->GetComponentTransform(), WalkableCos);
+			}
+		}
+	}
+
+	Index.BuildCells(CellSize);
+
+	if (bBakeHopTargets)
+	{
+		BakeHopCells(WalkableCos);
+	}
+
+	UE_LOG(LogClimbSurfaceIndex, Log, TEXT("%s: baked %d climb quads, %d triangles, %d ledge edges in %d cells, %d hop cells, %d unbaked bounds"),
+		*GetName(), Index.Quads.Num(), Index.Triangles.Num(), Index.LedgeEdges.Num(), Index.Cells.Num(), Index.HopCells.Num(), Index.UnbakedBounds.Num());
+}
+
+bool AClimbSurfaceIndexActor::CanBakeBodySetup(const UBodySetup* InBodySetup)
+{
+	if (!InBodySetup) return false;
+	if (InBodySetup->GetCollisionTraceFlag() == CTF_UseComplexAsSimple) return false;
+
+	const FKAggregateGeom& AggGeom = InBodySetup->AggGeom;
+
+	if (AggGeom.BoxElems.IsEmpty() && AggGeom.ConvexElems.IsEmpty()) return false;
+
+	return AggGeom.SphereElems.IsEmpty() && AggGeom.SphylElems.IsEmpty() && AggGeom.TaperedCapsuleElems.IsEmpty() && AggGeom.LevelSetElems.IsEmpty();
+}
+
+void AClimbSurfaceIndexActor::AddBodySetup(const UBodySetup& InBodySetup, const FTransform& InComponentTransform, float InWalkableCos)
+{
+	for (const FKBoxElem& BoxElem : InBodySetup.AggGeom.BoxElems)
+	{
+		AddBoxFaces(BoxElem.GetTransform() * InComponentTransform, FVector(BoxElem.X, BoxElem.Y, BoxElem.Z) * 0.5f, InWalkableCos);
+	}
+
+	for (const FKConvexElem& ConvexElem : InBodySetup.AggGeom.ConvexElems)
+	{
+		AddConvexFaces(ConvexElem, ConvexElem.GetTransform() * InComponentTransform, InWalkableCos);
+	}
+}
+
+void AClimbSurfaceIndexActor::BakeHopCells(float InWalkableCos)
+{
+	Index.HopCellSize = HopCellSize;
+	Index.HopCells.Reset();
+
+	const ACharacter* ClimbingCharacter = ClimbingCharacterClass ? ClimbingCharacterClass->GetDefaultObject<ACharacter>() : nullptr;
+
+	if (!ClimbingCharacter || !ClimbingCharacter->GetCapsuleComponent())
+	{
+		UE_LOG(LogClimbSurfaceIndex, Warning, TEXT("%s: no climbing character class set, hop targets aren't baked"), *GetName());
+		return;
+	}
+
+	// The climb snap rests the capsule against the wall, so its center is a radius out
+	Index.HopEyeHeight = ClimbingCharacter->BaseEyeHeight;
+	Index.HopWallStandOff = ClimbingCharacter->GetCapsuleComponent()->GetScaledCapsuleRadius();
+
+	// Same limit CheckShouldStopClimbing uses, anything steeper than 60 degrees from vertical isn't climbed
+	const float MaxClimbableNormalZ = FMath::Cos(FMath::DegreesToRadians(60.f));
+
+	for (const FClimbSurfaceQuad& Quad : Index.Quads)
+	{
+		if (Quad.bWalkable || FMath::Abs(Quad.Normal.Z) >= MaxClimbableNormalZ) continue;
+
+		const FVector2D HalfExtents = FVector2D(Quad.HalfExtents);
+
+		BakeHopCellsOnFace(Quad.Center, FVector(Quad.AxisU), FVector(Quad.AxisV), -HalfExtents, HalfExtents, FVector(Quad.Normal), InWalkableCos,
+			[](const FVector&) { return true; });
+	}
+
+	for (const FClimbSurfaceTriangle& Triangle : Index.Triangles)
+	{
+		if (Triangle.bWalkable || FMath::Abs(Triangle.Normal.Z) >= MaxClimbableNormalZ) continue;
+
+		const FVector Normal = FVector(Triangle.Normal);
+		const FVector AxisU = (Triangle.B - Triangle.A).GetSafeNormal();
+		const FVector AxisV = FVector::CrossProduct(Normal, AxisU);
+
+		const FVector2D PointB(FVector::DotProduct(Triangle.B - Triangle.A, AxisU), FVector::DotProduct(Triangle.B - Triangle.A, AxisV));
+		const FVector2D PointC(FVector::DotProduct(Triangle.C - Triangle.A, AxisU), FVector::DotProduct(Triangle.C - Triangle.A, AxisV));
+
+		BakeHopCellsOnFace(Triangle.A, AxisU, AxisV, FVector2D::Min(FVector2D::ZeroVector, FVector2D::Min(PointB, PointC)),
+			FVector2D::Max(FVector2D::ZeroVector, FVector2D::Max(PointB, PointC)), Normal, InWalkableCos,
+			[&Triangle](const FVector& InPoint) { return Triangle.ContainsPlanePoint(InPoint); });
+	}
+}
+
+void AClimbSurfaceIndexActor::BakeHopCellsOnFace(const FVector& InOrigin, const FVector& InAxisU, const FVector& InAxisV, const FVector2D& InMin, const FVector2D& InMax,
+	const FVector& InNormal, float InWalkableCos, TFunctionRef<bool(const FVector&)> InContains)
+{
+	// Sample at half the cell size so every cell a wall passes through gets at least one sample
+	const float SampleSpacing = HopCellSize * 0.5f;
+
+	for (double U = InMin.X; U <= InMax.X; U += SampleSpacing)
+	{
+		for (double V = InMin.Y; V <= InMax.Y; V += SampleSpacing)
+		{
+			const FVector WallPoint = InOrigin + InAxisU * U + InAxisV * V;
+			if (!InContains(WallPoint)) continue;
+
+			const FIntVector HopCellCoord = Index.GetHopCellCoord(WallPoint, InNormal);
+
+			if (Index.HopCells.Contains(HopCellCoord)) continue;
+
+			FClimbHopCell HopCell;
+			if (EvaluateHopCell(WallPoint, InNormal, InWalkableCos, HopCell))
+			{
+				Index.HopCells.Add(HopCellCoord, HopCell);
+			}
+		}
+	}
+}
+
+bool AClimbSurfaceIndexActor::EvaluateHopCell(const FVector& InWallPoint, const FVector& InWallNormal, float InWalkableCos, FClimbHopCell& OutHopCell) const
+{
+	// Capsule center and rotation of a character climbing at this point, facing into the wall
+	const FVector ClimberLocation = InWallPoint + InWallNormal * Index.HopWallStandOff;
+	const FQuat ClimberQuat = ClimbMath::GetClimbTargetQuat(InWallNormal);
+	const FVector Forward = ClimberQuat.GetForwardVector();
+	const FVector Up = ClimberQuat.GetUpVector();
+
+	auto EyeTrace = [&](float InOffset, FHitResult& OutHit)
+	{
+		const FVector Start = ClimberLocation + Up * (Index.HopEyeHeight + InOffset);
+		return Index.Raycast(Start, Start + Forward * EyeTraceDistance, OutHit);
+	};
+
+	OutHopCell.WallNormal = FVector3f(InWallNormal);
+
+	FHitResult HopUpHit;
+	FHitResult SafetyLedgeHit;
+	if (EyeTrace(HopUpOffset, HopUpHit) && EyeTrace(HopUpSafetyLedgeOffset, SafetyLedgeHit))
+	{
+		OutHopCell.bCanHopUp = true;
+		OutHopCell.HopUpOffset = FVector3f(HopUpHit.ImpactPoint - InWallPoint);
+	}
+
+	FHitResult HopDownHit;
+	if (EyeTrace(HopDownOffset, HopDownHit))
+	{
+		OutHopCell.bCanHopDown = true;
+		OutHopCell.HopDownOffset = FVector3f(HopDownHit.ImpactPoint - InWallPoint);
+	}
+
+	FHitResult LedgeHit;
+	if (!EyeTrace(MantleOffset, LedgeHit))
+	{
+		FHitResult WalkableHit;
+		const FVector WalkableTraceStart = LedgeHit.TraceEnd;
+
+		OutHopCell.bCanMantle = Index.Raycast(WalkableTraceStart, WalkableTraceStart - Up * MantleWalkableTraceDistance, WalkableHit) &&
+			WalkableHit.ImpactNormal.Z >= InWalkableCos;
+	}
+
+	return OutHopCell.bCanHopUp || OutHopCell.bCanHopDown || OutHopCell.bCanMantle;
+}
+
+void AClimbSurfaceIndexActor::AddBoxFaces(const FTransform& InBoxTransform, const FVector& InHalfExtents, float InWalkableCos)
+{
+	const FVector Center = InBoxTransform.GetLocation();
+
+	const FVector Axes[3] =
+	{
+		InBoxTransform.TransformVector(FVector(InHalfExtents.X, 0.f, 0.f)),
+		InBoxTransform.TransformVector(FVector(0.f, InHalfExtents.Y, 0.f)),
+		InBoxTransform.TransformVector(FVector(0.f, 0.f, InHalfExtents.Z))
+	};
+
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		const FVector& ExtentU = Axes[(Axis + 1) % 3];
+		const FVector& ExtentV = Axes[(Axis + 2) % 3];
+
+		for (int32 Side = -1; Side <= 1; Side += 2)
+		{
+			const FVector FaceOffset = Axes[Axis] * Side;
+
+			FClimbSurfaceQuad Quad;
+			Quad.Center = Center + FaceOffset;
+			Quad.Normal = FVector3f(FaceOffset.GetSafeNormal());
+			Quad.AxisU = FVector3f(ExtentU.GetSafeNormal());
+			Quad.AxisV = FVector3f(ExtentV.GetSafeNormal());
+			Quad.HalfExtents = FVector2f(FVector2D(ExtentU.Size(), ExtentV.Size()));
+			Quad.bWalkable = Quad.Normal.Z >= InWalkableCos;
+
+			if (!Index.Bounds.Intersect(Quad.GetBounds())) continue;
+
+			Index.Quads.Add(Quad);
+
+			if (!Quad.bWalkable) continue;
+
+			// Every edge of a walkable top is a ledge, the wall below it faces out from the edge
+			const FVector EdgeOffsets[4] = { ExtentU, -ExtentU, ExtentV, -ExtentV };
+			const FVector EdgeDirections[4] = { ExtentV, ExtentV, ExtentU, ExtentU };
+
+			for (int32 Edge = 0; Edge < 4; Edge++)
+			{
+				const FVector EdgeCenter = Quad.Center + EdgeOffsets[Edge];
+
+				FClimbLedgeEdge& LedgeEdge = Index.LedgeEdges.AddDefaulted_GetRef();
+				LedgeEdge.Start = EdgeCenter - EdgeDirections[Edge];
+				LedgeEdge.End = EdgeCenter + EdgeDirections[Edge];
+				LedgeEdge.WallNormal = FVector3f(EdgeOffsets[Edge].GetSafeNormal());
+			}
+		}
+	}
+}
+
+void AClimbSurfaceIndexActor::AddConvexFaces(const FKConvexElem& InConvexElem, const FTransform& InElemTransform, float InWalkableCos)
+{
+	// Hulls cooked without face indices get them computed on a copy, the mesh's own body setup is left alone
+	FKConvexElem IndexedElem;
+	const FKConvexElem* ConvexElem = &InConvexElem;
+
+	if (InConvexElem.IndexData.IsEmpty())
+	{
+		IndexedElem = InConvexElem;
+		IndexedElem.ComputeChaosConvexIndices();
+		ConvexElem = &IndexedElem;
+	}
+
+	const TArray<int32>& IndexData = ConvexElem->IndexData;
+	if (ConvexElem->VertexData.IsEmpty() || IndexData.Num() < 3) return;
+
+	TArray<FVector, TInlineAllocator<64>> Vertices;
+	FVector HullCenter = FVector::ZeroVector;
+
+	for (const FVector& Vertex : ConvexElem->VertexData)
+	{
+		HullCenter += Vertices.Add_GetRef(InElemTransform.TransformPosition(Vertex));
+	}
+
+	HullCenter /= Vertices.Num();
+
+	struct FHullFace
+	{
+		int32 Corners[3];
+		FVector Normal;
+		bool bWalkable;
+	};
+
+	TArray<FHullFace, TInlineAllocator<64>> Faces;
+
+	for (int32 i = 0; i + 2 < IndexData.Num(); i += 3)
+	{
+		FHullFace Face = { { IndexData[i], IndexData[i + 1], IndexData[i + 2] }, FVector::ZeroVector, false };
+
+		const FVector& A = Vertices[Face.Corners[0]];
+		Face.Normal = FVector::CrossProduct(Vertices[Face.Corners[1]] - A, Vertices[Face.Corners[2]] - A).GetSafeNormal();
+		if (Face.Normal.IsZero()) continue; // Degenerate sliver
+
+		// The winding isn't guaranteed, a convex hull's faces all point away from its center
+		if (FVector::DotProduct(Face.Normal, A - HullCenter) < 0.0)
+		{
+			Swap(Face.Corners[1], Face.Corners[2]);
+			Face.Normal = -Face.Normal;
+		}
+
+		Face.bWalkable = Face.Normal.Z >= InWalkableCos;
+		Faces.Add(Face);
+	}
+
+	// Faces sharing each edge, to find where a walkable top meets a wall
+	TMap<TPair<int32, int32>, TArray<int32, TInlineAllocator<2>>> FacesByEdge;
+
+	for (int32 FaceIndex = 0; FaceIndex < Faces.Num(); FaceIndex++)
+	{
+		for (int32 Corner = 0; Corner < 3; Corner++)
+		{
+			const int32 V0 = Faces[FaceIndex].Corners[Corner];
+			const int32 V1 = Faces[FaceIndex].Corners[(Corner + 1) % 3];
+
+			FacesByEdge.FindOrAdd(TPair<int32, int32>(FMath::Min(V0, V1), FMath::Max(V0, V1))).Add(FaceIndex);
+		}
+	}
+
+	for (int32 FaceIndex = 0; FaceIndex < Faces.Num(); FaceIndex++)
+	{
+		const FHullFace& Face = Faces[FaceIndex];
+
+		FClimbSurfaceTriangle Triangle;
+		Triangle.A = Vertices[Face.Corners[0]];
+		Triangle.B = Vertices[Face.Corners[1]];
+		Triangle.C = Vertices[Face.Corners[2]];
+		Triangle.Normal = FVector3f(Face.Normal);
+		Triangle.bWalkable = Face.bWalkable;
+
+		if (!Index.Bounds.Intersect(Triangle.GetBounds())) continue;
+
+		Index.Triangles.Add(Triangle);
+
+		if (!Face.bWalkable) continue;
+
+		// An edge of a walkable face is a ledge where the face on the other side isn't walkable, a ramp's split diagonal isn't
+		for (int32 Corner = 0; Corner < 3; Corner++)
+		{
+			const int32 V0 = Face.Corners[Corner];
+			const int32 V1 = Face.Corners[(Corner + 1) % 3];
+
+			const FVector& EdgeStart = Vertices[V0];
+			const FVector& EdgeEnd = Vertices[V1];
+			const FVector& Opposite = Vertices[Face.Corners[(Corner + 2) % 3]];
+
+			const FHullFace* WallFace = nullptr;
+			bool bWalkableNeighbour = false;
+
+			for (const int32 Neighbour : FacesByEdge.FindChecked(TPair<int32, int32>(FMath::Min(V0, V1), FMath::Max(V0, V1))))
+			{
+				if (Neighbour == FaceIndex) continue;
+
+				if (Faces[Neighbour].bWalkable)
+				{
+					bWalkableNeighbour = true;
+				}
+				else
+				{
+					WallFace = &Faces[Neighbour];
+				}
+			}
+
+			if (bWalkableNeighbour && !WallFace) continue;
+
+			// The wall below faces out from the edge, away from the rest of the walkable face
+			FVector EdgeOut = FVector::CrossProduct(EdgeEnd - EdgeStart, Face.Normal).GetSafeNormal();
+			if (FVector::DotProduct(EdgeOut, (EdgeStart + EdgeEnd) * 0.5 - Opposite) < 0.0)
+			{
+				EdgeOut = -EdgeOut;
+			}
+
+			FClimbLedgeEdge& LedgeEdge = Index.LedgeEdges.AddDefaulted_GetRef();
+			LedgeEdge.Start = EdgeStart;
+			LedgeEdge.End = EdgeEnd;
+			LedgeEdge.WallNormal = FVector3f(WallFace ? WallFace->Normal : EdgeOut);
+		}
+	}
+}
+#endif
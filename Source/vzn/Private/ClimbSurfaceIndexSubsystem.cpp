@@ -0,0 +1,150 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ClimbSurfaceIndexSubsystem.h"
+#include "ClimbSurfaceIndexActor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+void UClimbSurfaceIndexSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	ActorSpawnedHandle = GetWorld()->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UClimbSurfaceIndexSubsystem::OnActorSpawned));
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UClimbSurfaceIndexSubsystem::OnLevelAddedToWorld);
+}
+
+void UClimbSurfaceIndexSubsystem::Deinitialize()
+{
+	GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+
+	Super::Deinitialize();
+}
+
+void UClimbSurfaceIndexSubsystem::RegisterIndex(AClimbSurfaceIndexActor* InIndexActor)
+{
+	if (!InIndexActor) return;
+
+	IndexActors.AddUnique(InIndexActor);
+	RebuildMovableClimbables();
+}
+
+void UClimbSurfaceIndexSubsystem::UnregisterIndex(AClimbSurfaceIndexActor* InIndexActor)
+{
+	IndexActors.RemoveSwap(InIndexActor);
+	RebuildMovableClimbables();
+}
+
+const FClimbSurfaceIndex* UClimbSurfaceIndexSubsystem::FindIndex(const FBox& InQueryBounds) const
+{
+	// Only a handful of index actors are loaded at once, a linear scan is fine
+	for (const AClimbSurfaceIndexActor* IndexActor : IndexActors)
+	{
+		if (!IndexActor) continue;
+
+		const FClimbSurfaceIndex& Index = IndexActor->GetIndex();
+
+		if (Index.Covers(InQueryBounds))
+		{
+			return &Index;
+		}
+	}
+
+	return nullptr;
+}
+
+const FClimbHopCell* UClimbSurfaceIndexSubsystem::FindHopCell(const FVector& InWallPoint, const FVector& InWallNormal, float InEyeHeight, float InWallStandOff) const
+{
+	for (const AClimbSurfaceIndexActor* IndexActor : IndexActors)
+	{
+		if (!IndexActor) continue;
+
+		const FClimbSurfaceIndex& Index = IndexActor->GetIndex();
+		if (!Index.Bounds.IsInside(InWallPoint)) continue;
+		if (!Index.HasHopCellsFor(InEyeHeight, InWallStandOff)) continue;
+
+		if (const FClimbHopCell* HopCell = Index.FindHopCell(InWallPoint, InWallNormal))
+		{
+			return HopCell;
+		}
+	}
+
+	return nullptr;
+}
+
+bool UClimbSurfaceIndexSubsystem::OverlapsMovableClimbable(const FBox& InQueryBounds) const
+{
+	// Movable climbables are lifts and props, few enough for a linear scan, their bounds are read live since they move
+	for (const TWeakObjectPtr<UPrimitiveComponent>& Primitive : MovableClimbables)
+	{
+		if (!Primitive.IsValid()) continue;
+		if (!Primitive->IsQueryCollisionEnabled()) continue;
+
+		if (Primitive->Bounds.GetBox().Intersect(InQueryBounds))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UClimbSurfaceIndexSubsystem::RebuildMovableClimbables()
+{
+	MovableClimbables.Reset();
+	ClimbableChannels.Reset();
+
+	for (const AClimbSurfaceIndexActor* IndexActor : IndexActors)
+	{
+		if (!IndexActor) continue;
+
+		for (const ECollisionChannel Channel : IndexActor->GetClimbableChannels())
+		{
+			ClimbableChannels.AddUnique(Channel);
+		}
+	}
+
+	if (ClimbableChannels.IsEmpty()) return;
+
+	for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+	{
+		AddMovableClimbables(*It);
+	}
+}
+
+void UClimbSurfaceIndexSubsystem::AddMovableClimbables(const AActor* InActor)
+{
+	if (!InActor || ClimbableChannels.IsEmpty()) return;
+
+	TInlineComponentArray<UPrimitiveComponent*> Primitives(InActor);
+
+	for (UPrimitiveComponent* Primitive : Primitives)
+	{
+		// Static and stationary collision is in the baked index
+		if (Primitive->Mobility != EComponentMobility::Movable) continue;
+		if (!ClimbableChannels.Contains(Primitive->GetCollisionObjectType())) continue;
+
+		MovableClimbables.Add(Primitive);
+	}
+}
+
+void UClimbSurfaceIndexSubsystem::OnActorSpawned(AActor* InActor)
+{
+	// Drop destroyed actors here so spawned and destroyed props don't pile up
+	MovableClimbables.RemoveAllSwap([](const TWeakObjectPtr<UPrimitiveComponent>& Primitive) { return !Primitive.IsValid(); });
+
+	AddMovableClimbables(InActor);
+}
+
+void UClimbSurfaceIndexSubsystem::OnLevelAddedToWorld(ULevel* InLevel, UWorld* InWorld)
+{
+	if (InWorld != GetWorld() || !InLevel) return;
+
+	for (const AActor* Actor : InLevel->Actors)
+	{
+		AddMovableClimbables(Actor);
+	}
+}
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Components/ClimbProxyComponent.h"
+#include "Components/ClimbCollision.h"
+#include "Components/BoxComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "PhysicsEngine/BodySetup.h"
+
+UClimbProxyComponent::UClimbProxyComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UClimbProxyComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	BuildProxies();
+}
+
+void UClimbProxyComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	for (UPrimitiveComponent* Proxy : Proxies)
+	{
+		if (Proxy) Proxy->DestroyComponent();
+	}
+
+	Proxies.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UClimbProxyComponent::BuildProxies()
+{
+	AActor* Owner = GetOwner();
+	if (!Owner) return;
+
+	TInlineComponentArray<UStaticMeshComponent*> MeshComponents(Owner);
+
+	for (UStaticMeshComponent* MeshComponent : MeshComponents)
+	{
+		if (!MeshTag.IsNone() && !MeshComponent->ComponentHasTag(MeshTag)) continue;
+		if (!MeshComponent->GetStaticMesh()) continue;
+
+		BuildMeshProxies(MeshComponent);
+	}
+}
+
+void UClimbProxyComponent::BuildMeshProxies(UStaticMeshComponent* InMesh)
+{
+	if (bUseMeshBoundsOnly)
+	{
+		const FBox MeshBounds = InMesh->GetStaticMesh()->GetBoundingBox();
+		AddBoxProxy(InMesh, FTransform(MeshBounds.GetCenter()), MeshBounds.GetExtent());
+		return;
+	}
+
+	const UBodySetup* BodySetup = InMesh->GetBodySetup();
+	const FKAggregateGeom* AggGeom = BodySetup ? &BodySetup->AggGeom : nullptr;
+
+	const bool bBoxesOnly = AggGeom && BodySetup->GetCollisionTraceFlag() != CTF_UseComplexAsSimple &&
+		AggGeom->BoxElems.Num() > 0 && AggGeom->BoxElems.Num() == AggGeom->GetElementCount();
+
+	// A box can't stand in for a sloped hull or for complex collision without turning it into a wall, copy the real collision instead
+	if (!bBoxesOnly)
+	{
+		AddMeshProxy(InMesh);
+		return;
+	}
+
+	for (const FKBoxElem& BoxElem : AggGeom->BoxElems)
+	{
+		AddBoxProxy(InMesh, BoxElem.GetTransform(), FVector(BoxElem.X, BoxElem.Y, BoxElem.Z) * 0.5f);
+	}
+}
+
+void UClimbProxyComponent::AddBoxProxy(UStaticMeshComponent* InMesh, const FTransform& InRelativeTransform, const FVector& InExtent)
+{
+	UBoxComponent* Proxy = NewObject<UBoxComponent>(GetOwner(), NAME_None, RF_Transient);
+	Proxy->SetBoxExtent(InExtent.ComponentMax(FVector(MinProxyExtent)), false);
+
+	AddProxy(Proxy, InMesh, InRelativeTransform);
+}
+
+void UClimbProxyComponent::AddMeshProxy(UStaticMeshComponent* InMesh)
+{
+	UStaticMeshComponent* Proxy = NewObject<UStaticMeshComponent>(GetOwner(), NAME_None, RF_Transient);
+	Proxy->SetStaticMesh(InMesh->GetStaticMesh());
+	Proxy->SetVisibility(false); // Collision only, never added to the scene
+	Proxy->SetCastShadow(false);
+
+	AddProxy(Proxy, InMesh, FTransform::Identity);
+}
+
+void UClimbProxyComponent::AddProxy(UPrimitiveComponent* InProxy, UStaticMeshComponent* InMesh, const FTransform& InRelativeTransform)
+{
+	// Attached to the mesh, so proxies of moving meshes move with them
+	InProxy->SetMobility(InMesh->Mobility);
+	InProxy->SetupAttachment(InMesh);
+	InProxy->SetRelativeTransform(InRelativeTransform);
+	InProxy->SetCollisionProfileName(ClimbProxyProfileName);
+	InProxy->SetGenerateOverlapEvents(false);
+	InProxy->SetCanEverAffectNavigation(false);
+	InProxy->RegisterComponent();
+
+	Proxies.Add(InProxy);
+}
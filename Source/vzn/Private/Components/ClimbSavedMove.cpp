@@ -0,0 +1,191 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/ClimbSavedMove.h"
+#include "Components/CustomMovementComponent.h"
+#include "GameFramework/Character.h"
+
+FSavedMove_Climb::FSavedMove_Climb()
+	: bSavedWantsToClimb(false)
+	, bSavedWantsToHop(false)
+	, bSavedClimbing(false)
+	, bSavedWantsToSlide(false)
+	, bSavedWantsToGrapple(false)
+	, bSavedGrappling(false)
+{
+}
+
+void FSavedMove_Climb::Clear()
+{
+	Super::Clear();
+
+	bSavedWantsToClimb = false;
+	bSavedWantsToHop = false;
+	bSavedClimbing = false;
+	bSavedWantsToSlide = false;
+	bSavedWantsToGrapple = false;
+	bSavedGrappling = false;
+	SavedClimbSurfaceNormal = FVector::ZeroVector;
+	SavedClimbStepAccumulator = 0.f;
+	SavedGrappleAnchor = FVector::ZeroVector;
+	SavedGrappleRopeAnchor = FVector::ZeroVector;
+	SavedGrappleRopeLength = 0.f;
+}
+
+uint8 FSavedMove_Climb::GetCompressedFlags() const
+{
+	uint8 Result = Super::GetCompressedFlags();
+
+	if (bSavedWantsToClimb)
+	{
+		Result |= FLAG_Climb;
+	}
+
+	if (bSavedWantsToHop)
+	{
+		Result |= FLAG_Hop;
+	}
+
+	if (bSavedWantsToSlide)
+	{
+		Result |= FLAG_Slide;
+	}
+
+	if (bSavedWantsToGrapple)
+	{
+		Result |= FLAG_Grapple;
+	}
+
+	return Result;
+}
+
+bool FSavedMove_Climb::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	const FSavedMove_Climb* NewClimbMove = static_cast<const FSavedMove_Climb*>(NewMove.Get());
+
+	// The hop only fires once, the move carrying it has to reach the server on its own
+	if (bSavedWantsToHop || NewClimbMove->bSavedWantsToHop) return false;
+
+	if (bSavedWantsToClimb != NewClimbMove->bSavedWantsToClimb) return false;
+
+	if (bSavedWantsToSlide != NewClimbMove->bSavedWantsToSlide) return false;
+
+	if (bSavedWantsToGrapple != NewClimbMove->bSavedWantsToGrapple || bSavedGrappling != NewClimbMove->bSavedGrappling) return false;
+	if (bSavedWantsToGrapple && SavedGrappleAnchor != NewClimbMove->SavedGrappleAnchor) return false;
+
+	if (bSavedClimbing != NewClimbMove->bSavedClimbing) return false;
+
+	// Steady climbing on one face combines like walking, moving onto a new face is sent separately
+	if (bSavedClimbing)
+	{
+		const UCustomMovementComponent* MoveComp = InCharacter ? Cast<UCustomMovementComponent>(InCharacter->GetCharacterMovement()) : nullptr;
+		if (!MoveComp) return false;
+
+		const float MinNormalDot = FMath::Cos(FMath::DegreesToRadians(MoveComp->ClimbMoveCombineMaxAngle));
+		if (FVector::DotProduct(SavedClimbSurfaceNormal, NewClimbMove->SavedClimbSurfaceNormal) < MinNormalDot) return false;
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_Climb::CombineWith(const FSavedMove_Character* OldMove, ACharacter* InCharacter, APlayerController* PC, const FVector& OldStartLocation)
+{
+	Super::CombineWith(OldMove, InCharacter, PC, OldStartLocation);
+
+	UCustomMovementComponent* MoveComp = InCharacter ? Cast<UCustomMovementComponent>(InCharacter->GetCharacterMovement()) : nullptr;
+	if (!MoveComp) return;
+
+	// The combined move is simulated again from the old move's start, fixed step remainder included
+	const FSavedMove_Climb* OldClimbMove = static_cast<const FSavedMove_Climb*>(OldMove);
+
+	if (OldClimbMove->bSavedClimbing)
+	{
+		MoveComp->CurrentClimbableSurfaceNormal = OldClimbMove->SavedClimbSurfaceNormal;
+		MoveComp->ClimbStepAccumulator = OldClimbMove->SavedClimbStepAccumulator;
+	}
+}
+
+void FSavedMove_Climb::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	const UCustomMovementComponent* MoveComp = Cast<UCustomMovementComponent>(C->GetCharacterMovement());
+	if (!MoveComp) return;
+
+	bSavedWantsToClimb = MoveComp->bWantsToClimb;
+	bSavedWantsToHop = MoveComp->bWantsToHop;
+	bSavedClimbing = MoveComp->IsClimbing();
+	bSavedWantsToSlide = MoveComp->bWantsToSlide;
+	bSavedWantsToGrapple = MoveComp->bWantsToGrapple;
+	bSavedGrappling = MoveComp->IsGrappling();
+	SavedGrappleAnchor = MoveComp->GrappleRequestAnchor;
+	SavedGrappleRopeAnchor = MoveComp->GrappleAnchor;
+	SavedGrappleRopeLength = MoveComp->GrappleRopeLength;
+	SavedClimbSurfaceNormal = MoveComp->CurrentClimbableSurfaceNormal;
+	SavedClimbStepAccumulator = MoveComp->ClimbStepAccumulator;
+}
+
+void FSavedMove_Climb::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	UCustomMovementComponent* MoveComp = Cast<UCustomMovementComponent>(C->GetCharacterMovement());
+	if (!MoveComp) return;
+
+	// Replays restore the held state only, the hop already happened and isn't fired again
+	MoveComp->bWantsToClimb = bSavedWantsToClimb;
+	MoveComp->bWantsToSlide = bSavedWantsToSlide;
+	MoveComp->bWantsToGrapple = bSavedWantsToGrapple;
+	MoveComp->GrappleRequestAnchor = SavedGrappleAnchor;
+
+	if (bSavedClimbing)
+	{
+		MoveComp->CurrentClimbableSurfaceNormal = SavedClimbSurfaceNormal;
+		MoveComp->ClimbStepAccumulator = SavedClimbStepAccumulator;
+	}
+
+	// The rope reels in every substep, a replay has to start from the length this move started with
+	if (bSavedGrappling)
+	{
+		MoveComp->GrappleAnchor = SavedGrappleRopeAnchor;
+		MoveComp->GrappleRopeLength = SavedGrappleRopeLength;
+	}
+}
+
+void FCharacterNetworkMoveData_Climb::ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType)
+{
+	Super::ClientFillNetworkMoveData(ClientMove, MoveType);
+
+	GrappleAnchor = static_cast<const FSavedMove_Climb&>(ClientMove).SavedGrappleAnchor;
+}
+
+bool FCharacterNetworkMoveData_Climb::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
+{
+	const bool bSuccess = Super::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+
+	// The flags are already serialized, so both sides agree on whether the anchor follows
+	if (CompressedMoveFlags & FSavedMove_Climb::FLAG_Grapple)
+	{
+		bool bAnchorSuccess = true;
+		GrappleAnchor.NetSerialize(Ar, PackageMap, bAnchorSuccess);
+	}
+
+	return bSuccess && !Ar.IsError();
+}
+
+FCharacterNetworkMoveDataContainer_Climb::FCharacterNetworkMoveDataContainer_Climb()
+{
+	NewMoveData = &ClimbMoveData[0];
+	PendingMoveData = &ClimbMoveData[1];
+	OldMoveData = &ClimbMoveData[2];
+}
+
+FNetworkPredictionData_Client_Climb::FNetworkPredictionData_Client_Climb(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_Climb::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_Climb());
+}
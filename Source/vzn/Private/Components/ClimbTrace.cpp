@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Components/ClimbTrace.h"
+
+#if CLIMB_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_DEFINE(ClimbChannel)
+
+UE_TRACE_EVENT_BEGIN(Climb, SceneQuery)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, CharacterId)
+	UE_TRACE_EVENT_FIELD(uint8, Shape)
+	UE_TRACE_EVENT_FIELD(uint8, Purpose)
+	UE_TRACE_EVENT_FIELD(uint16, NumHits)
+	UE_TRACE_EVENT_FIELD(bool, BakedIndex)
+UE_TRACE_EVENT_END()
+
+void FClimbQueryTrace::OutputSceneQuery(uint32 InCharacterId, EClimbQueryShape::Type InShape, EClimbQueryPurpose::Type InPurpose, int32 InNumHits, bool bInBakedIndex)
+{
+	UE_TRACE_LOG(Climb, SceneQuery, ClimbChannel)
+		<< SceneQuery.Cycle(FPlatformTime::Cycles64())
+		<< SceneQuery.CharacterId(InCharacterId)
+		<< SceneQuery.Shape(uint8(InShape))
+		<< SceneQuery.Purpose(uint8(InPurpose))
+		<< SceneQuery.NumHits(uint16(FMath::Min(InNumHits, int32(MAX_uint16))))
+		<< SceneQuery.BakedIndex(bInBakedIndex);
+}
+
+#endif
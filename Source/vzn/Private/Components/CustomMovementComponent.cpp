@@ -2,11 +2,76 @@
 
 #include "Components/CustomMovementComponent.h"
 #include "Components/CapsuleComponent.h"
-#include "Kismet/KismetSystemLibrary.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/PlayerController.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "DrawDebugHelpers.h"
+#include "Components/ClimbStats.h"
+#include "Components/ClimbCollision.h"
+#include "Components/ClimbMath.h"
+#include "Components/ClimbSavedMove.h"
+#include "ClimbSurfaceIndexSubsystem.h"
+#include "ClimbSurfaceIndex.h"
+#include "ClimbQuerySubsystem.h"
+#include "GrappleTargetSubsystem.h"
 #include "vzn/vznCharacter.h"
 #include "vzn/DebugHelper.h"
 #include "MotionWarpingComponent.h"
+#include "Misc/ScopeExit.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Climb Trace Heap Allocations"), STAT_ClimbTraceHeapAllocations, STATGROUP_Climb);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Climb Scene Queries"), STAT_ClimbSceneQueries, STATGROUP_Climb);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Climb Baked Index Queries"), STAT_ClimbBakedIndexQueries, STATGROUP_Climb);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Climb Component Moves"), STAT_ClimbComponentMoves, STATGROUP_Climb);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Climb Net Corrections"), STAT_ClimbNetCorrections, STATGROUP_Climb);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Climb Dropped Surface Samples"), STAT_ClimbDroppedSurfaceSamples, STATGROUP_Climb);
+
+DECLARE_CYCLE_STAT(TEXT("PhysClimb"), STAT_PhysClimb, STATGROUP_Climb);
+DECLARE_CYCLE_STAT(TEXT("OnMovementModeChanged"), STAT_ClimbOnMovementModeChanged, STATGROUP_Climb);
+DECLARE_CYCLE_STAT(TEXT("Capsule Trace"), STAT_ClimbCapsuleTrace, STATGROUP_Climb);
+DECLARE_CYCLE_STAT(TEXT("Line Trace"), STAT_ClimbLineTrace, STATGROUP_Climb);
+DECLARE_CYCLE_STAT(TEXT("TraceClimbableSurfaces"), STAT_TraceClimbableSurfaces, STATGROUP_Climb);
+DECLARE_CYCLE_STAT(TEXT("TraceFromEyeHeight"), STAT_TraceFromEyeHeight, STATGROUP_Climb);
+DECLARE_CYCLE_STAT(TEXT("CheckShouldStopClimbing"), STAT_CheckShouldStopClimbing, STATGROUP_Climb);
+DECLARE_CYCLE_STAT(TEXT("CheckHasReachedFloor"), STAT_CheckHasReachedFloor, STATGROUP_Climb);
+DECLARE_CYCLE_STAT(TEXT("CheckHasReachedLedge"), STAT_CheckHasReachedLedge, STATGROUP_Climb);
+DECLARE_CYCLE_STAT(TEXT("CheckCanHopUp"), STAT_CheckCanHopUp, STATGROUP_Climb);
+DECLARE_CYCLE_STAT(TEXT("CheckCanHopDown"), STAT_CheckCanHopDown, STATGROUP_Climb);
+DECLARE_CYCLE_STAT(TEXT("GetClimbSnapDelta"), STAT_GetClimbSnapDelta, STATGROUP_Climb);
+DECLARE_CYCLE_STAT(TEXT("Climb Proxy Smoothing"), STAT_ClimbProxySmoothing, STATGROUP_Climb);
+DECLARE_CYCLE_STAT(TEXT("PhysSlide"), STAT_PhysSlide, STATGROUP_Climb);
+DECLARE_CYCLE_STAT(TEXT("PhysGrapple"), STAT_PhysGrapple, STATGROUP_Climb);
+
+DEFINE_LOG_CATEGORY_STATIC(LogClimbMovement, Log, All);
+
+// Append the parts of the hits the climb maths reads to a compact sample buffer, returns how many didn't fit
+static int32 AppendClimbSurfaceSamples(TConstArrayView<FHitResult> InHits, FClimbSurfaceSamples& OutSamples)
+{
+	for (int32 HitIndex = 0; HitIndex < InHits.Num(); HitIndex++)
+	{
+		const FHitResult& Hit = InHits[HitIndex];
+		const UPrimitiveComponent* HitComponent = Hit.GetComponent();
+		const uint32 PrimitiveId = HitComponent ? HitComponent->ComponentId.PrimIDValue : 0;
+
+		if (!OutSamples.Add(Hit.ImpactPoint, Hit.ImpactNormal, PrimitiveId))
+		{
+			return InHits.Num() - HitIndex;
+		}
+	}
+
+	return 0;
+}
+
+static int32 PackClimbSurfaceSamples(TConstArrayView<FHitResult> InHits, const FVector& InOrigin, FClimbSurfaceSamples& OutSamples)
+{
+	OutSamples.Reset(InOrigin);
+	return AppendClimbSurfaceSamples(InHits, OutSamples);
+}
+
+UCustomMovementComponent::UCustomMovementComponent()
+{
+	SetNetworkMoveDataContainer(ClimbMoveDataContainer);
+}
 
 void UCustomMovementComponent::BeginPlay()
 {
@@ -21,11 +86,54 @@ void UCustomMovementComponent::BeginPlay()
 	}
 
 	OwningPlayerCharacter = Cast<AvznCharacter>(CharacterOwner);
+
+	ClimbIndexSubsystem = GetWorld()->GetSubsystem<UClimbSurfaceIndexSubsystem>();
+
+	if (bUseBatchedClimbQueries)
+	{
+		ClimbQuerySubsystem = GetWorld()->GetSubsystem<UClimbQuerySubsystem>();
+
+		if (ClimbQuerySubsystem)
+		{
+			ClimbQuerySubsystem->RegisterComponent(this);
+		}
+	}
+
+	InitClimbTraceParams();
+
+	PublishMovementSnapshot();
+}
+
+void UCustomMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (ClimbQuerySubsystem)
+	{
+		ClimbQuerySubsystem->UnregisterComponent(this);
+		ClimbQuerySubsystem = nullptr;
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void UCustomMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	const float MovementDeltaTime = UpdateClimbLOD(DeltaTime);
+	if (MovementDeltaTime <= 0.f) return;
+
+	USkeletalMeshComponent* Mesh = CharacterOwner ? CharacterOwner->GetMesh() : nullptr;
+	const FVector MeshLocationBeforeMove = Mesh ? Mesh->GetComponentLocation() : FVector::ZeroVector;
+
+	Super::TickComponent(MovementDeltaTime, TickType, ThisTickFunction);
+
+	// Leave the mesh where it was and ease it onto the capsule until the next reduced rate step
+	if (ClimbLOD == EClimbLOD::Reduced && Mesh)
+	{
+		ClimbLODMeshOffset = MeshLocationBeforeMove - Mesh->GetComponentLocation();
+		ClimbLODMeshOffsetAlpha = 1.f;
+		UpdateClimbLODMeshOffset(0.f);
+	}
+
+	PublishMovementSnapshot();
 
 	/*TraceClimbableSurfaces();
 	TraceFromEyeHeight(80.f);*/
@@ -47,11 +155,35 @@ void UCustomMovementComponent::TickComponent(float DeltaTime, enum ELevelTick Ti
 
 void UCustomMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) 
 {
+	SCOPE_CYCLE_COUNTER(STAT_ClimbOnMovementModeChanged);
+
+	// Restore the standing capsule before another mode sets its own
+	if (PreviousMovementMode == MOVE_Custom && PreviousCustomMode == ECustomMovementMode::MOVE_Slide)
+	{
+		SetSlideCapsule(false);
+
+		OnExitSlideStateDelegate.ExecuteIfBound();
+	}
+
+	if (PreviousMovementMode == MOVE_Custom && PreviousCustomMode == ECustomMovementMode::MOVE_Grapple)
+	{
+		OnExitGrappleStateDelegate.ExecuteIfBound();
+	}
+
 	if (IsClimbing())
 	{
 		bOrientRotationToMovement = false;
 		CharacterOwner->GetCapsuleComponent()->SetCapsuleHalfHeight(48.f);
 
+		ClimbSurfaceCache.Invalidate();
+		LookAheadTraces.Invalidate();
+
+		bWantsToClimb = true; // Vaulting climbs without the input
+
+		ClimbStepAccumulator = 0.f;
+		ClimbPreviousStepLocation = UpdatedComponent->GetComponentLocation();
+		ClimbPreviousStepQuat = UpdatedComponent->GetComponentQuat();
+
 		OnEnterClimbStateDelegate.ExecuteIfBound();
 	}
 
@@ -66,9 +198,29 @@ void UCustomMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovem
 
 		StopMovementImmediately();
 
+		ClimbSurfaceCache.Invalidate();
+		LookAheadTraces.Invalidate();
+
+		SetClimbMeshOffset(FVector::ZeroVector);
+		ResetClimbProxy();
+
+		bWantsToClimb = false; // Climbs that end on their own don't start again on the next move
+
 		OnExitClimbStateDelegate.ExecuteIfBound();
 	}
 
+	if (IsSliding())
+	{
+		SetSlideCapsule(true);
+
+		OnEnterSlideStateDelegate.ExecuteIfBound();
+	}
+
+	if (IsGrappling())
+	{
+		OnEnterGrappleStateDelegate.ExecuteIfBound();
+	}
+
 	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
 }
 
@@ -78,6 +230,14 @@ void UCustomMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
 	{
 		PhysClimb(deltaTime, Iterations);
 	}
+	else if (IsSliding())
+	{
+		PhysSlide(deltaTime, Iterations);
+	}
+	else if (IsGrappling())
+	{
+		PhysGrapple(deltaTime, Iterations);
+	}
 
 	Super::PhysCustom(deltaTime, Iterations);
 }
@@ -88,6 +248,10 @@ float UCustomMovementComponent::GetMaxSpeed() const
 	{
 		return MaxClimbSpeed;
 	}
+	else if (IsSliding())
+	{
+		return SlideInitialSpeed;
+	}
 	else
 	{
 		return Super::GetMaxSpeed();
@@ -121,279 +285,1202 @@ FVector UCustomMovementComponent::ConstrainAnimRootMotionVelocity(const FVector&
 	}
 }
 
-#pragma region ClimbTraces
+#pragma region NetworkPrediction
 
-// Climb traces to handle raycasts and capsule trace for climbing 
-TArray<FHitResult> UCustomMovementComponent::DoCapsuleTraceMultiByObject(const FVector& Start, const FVector& End, bool bShowDebugShape, bool bDrawPersistantShapes)
+FNetworkPredictionData_Client* UCustomMovementComponent::GetPredictionData_Client() const
 {
-	TArray<FHitResult> OutCapsuleTraceHitResults;
+	if (!ClientPredictionData)
+	{
+		UCustomMovementComponent* MutableThis = const_cast<UCustomMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Climb(*this);
+	}
 
-	EDrawDebugTrace::Type DebugTraceType = EDrawDebugTrace::None;
+	return ClientPredictionData;
+}
 
-	if (bShowDebugShape)
-	{
-		DebugTraceType = EDrawDebugTrace::ForOneFrame;
+void UCustomMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
 
-		if (bDrawPersistantShapes)
+	bWantsToClimb = (Flags & FSavedMove_Climb::FLAG_Climb) != 0;
+	bWantsToHop = (Flags & FSavedMove_Climb::FLAG_Hop) != 0;
+	bWantsToSlide = (Flags & FSavedMove_Climb::FLAG_Slide) != 0;
+	bWantsToGrapple = (Flags & FSavedMove_Climb::FLAG_Grapple) != 0;
+
+	// The server takes the anchor from the move being processed, replays on the client restore it in PrepMoveFor
+	if (bWantsToGrapple && CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_Authority)
+	{
+		if (const FCharacterNetworkMoveData_Climb* MoveData = static_cast<const FCharacterNetworkMoveData_Climb*>(GetCurrentNetworkMoveData()))
 		{
-			DebugTraceType = EDrawDebugTrace::Persistent;
+			GrappleRequestAnchor = MoveData->GrappleAnchor;
 		}
 	}
-
-	UKismetSystemLibrary::CapsuleTraceMultiForObjects(
-		this,
-		Start,
-		End,
-		CapsuleTraceRadius,
-		CapsuleTraceHalfHeight,
-		ClimbableSurfaceTraceTypes,
-		false,
-		TArray<AActor*>(),
-		DebugTraceType,
-		OutCapsuleTraceHitResults,
-		false
-	);
-
-	return OutCapsuleTraceHitResults;
 }
 
-FHitResult UCustomMovementComponent::DoLineTraceSingleByObject(const FVector& Start, const FVector& End, bool bShowDebugShape, bool bDrawPersistantShapes)
+void UCustomMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
 {
-	FHitResult OutHit;
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+
+	// The server runs the same checks against its own surface data, so a client can't climb where the server can't
+	if (bWantsToClimb != IsClimbing())
+	{
+		ToggleClimbing(bWantsToClimb);
 
-	EDrawDebugTrace::Type DebugTraceType = EDrawDebugTrace::None;
+		// A climb that couldn't start isn't retried every move
+		bWantsToClimb = IsClimbing();
+	}
 
-	if (bShowDebugShape)
+	// Left for the next new move if it's still pending while older moves are replayed
+	if (bWantsToHop && !CharacterOwner->bClientUpdating)
 	{
-		DebugTraceType = EDrawDebugTrace::ForOneFrame;
+		bWantsToHop = false;
 
-		if (bDrawPersistantShapes)
+		if (IsClimbing())
 		{
-			DebugTraceType = EDrawDebugTrace::Persistent;
+			HandleHopRequest();
 		}
 	}
 
-	UKismetSystemLibrary::LineTraceSingleForObjects(
-		this,
-		Start,
-		End,
-		ClimbableSurfaceTraceTypes,
-		false,
-		TArray<AActor*>(),
-		DebugTraceType,
-		OutHit,
-		false
-	);
+	// PhysSlide ends the slide itself when it runs out of speed or floor
+	if (bWantsToSlide && !IsSliding() && CanStartSliding())
+	{
+		StartSliding();
+	}
+	else if (!bWantsToSlide && IsSliding())
+	{
+		StopSliding();
+	}
 
-	return OutHit;
+	if (bWantsToGrapple && !IsGrappling() && CanStartGrappling())
+	{
+		StartGrappling();
+	}
+	else if (!bWantsToGrapple && IsGrappling())
+	{
+		StopGrappling();
+	}
 }
 
-#pragma	endregion
-
-// Wall Running doesn't work properly, the character doesn't stick to the wall and gravity is messed up - Wall Running is disabled for now
-/*
-#pragma region Wall Run Traces 
-bool UCustomMovementComponent::TraceWallRunningSurfaces()
+bool UCustomMovementComponent::ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc, const FVector& RelativeClientLoc, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
 {
-	FVector Start = CharacterOwner->GetActorLocation() + FVector(0, 0, 50);  // Offset start to approximate chest height
-	FVector Direction = CharacterOwner->GetActorForwardVector();
-	FVector End = Start + Direction * 1000;  // Extend the trace 1000 units in front
+	const bool bClientError = Super::ServerCheckClientError(ClientTimeStamp, DeltaTime, Accel, ClientLoc, RelativeClientLoc, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
 
-	FHitResult HitResult;
-	FCollisionQueryParams CollisionParams;
-	CollisionParams.AddIgnoredActor(CharacterOwner);
-	GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, CollisionParams);
+	if (bClientError)
+	{
+		NumServerCorrections++;
+	}
 
-	return HitResult.bBlockingHit && HitResult.GetActor() != nullptr; // Ensure the hit is valid and is not the player
+	return bClientError;
 }
 
-#pragma endregion
-*/
+void UCustomMovementComponent::SmoothCorrection(const FVector& OldLocation, const FQuat& OldRotation, const FVector& NewLocation, const FQuat& NewRotation)
+{
+	if (!IsClimbingSimulatedProxy())
+	{
+		Super::SmoothCorrection(OldLocation, OldRotation, NewLocation, NewRotation);
+		return;
+	}
 
-#pragma region ClimbCore
+	const double Now = GetWorld()->GetTimeSeconds();
 
-void UCustomMovementComponent::ToggleClimbing(bool bEnableClimb)
-{
-	if (bEnableClimb)
+	if (!bClimbProxyActive)
 	{
-		if (CanStartClimbing())
-		{
-			// Enter climb state
-			PlayClimbMontage(IdleToClimbMontage);
-		}
-		else if (CanClimbDownLedge())
-		{
-			PlayClimbMontage(ClimbDownLedgeMontage);
-		}
-		else
-		{
-			TryStartVaulting(); // Check if the character can vault instead of climbing
-		}
+		// Take over from wherever the default smoothing had the mesh
+		const USkeletalMeshComponent* Mesh = CharacterOwner->GetMesh();
+		ClimbProxyLocation = Mesh ? Mesh->GetComponentLocation() - OldRotation.RotateVector(CharacterOwner->GetBaseTranslationOffset()) : OldLocation;
+		ClimbProxyQuat = OldRotation;
+		bClimbProxyActive = true;
 	}
-	
-	if(!bEnableClimb) // Toggle to stop climbing
+	else
 	{
-		StopClimbing();
+		ClimbProxyUpdateInterval = FMath::Clamp(float(Now - ClimbProxyLastUpdateTime), 1.f / 120.f, ClimbProxyMaxUpdateInterval);
 	}
-}
 
-bool UCustomMovementComponent::CanStartClimbing()
-{
-	// Checks for whether the character is falling, if the trace hits a climbable wall, and if the character is close enough to the wall
-	if (IsFalling()) return false;
-	if (!TraceClimbableSurfaces()) return false;
-	if (!TraceFromEyeHeight(100.f).bBlockingHit) return false; 
+	ClimbProxyLastUpdateTime = Now;
+	ClimbProxyFromLocation = ClimbProxyLocation;
+	ClimbProxyToLocation = NewLocation;
+	ClimbProxyAlpha = 0.f;
 
-	return true;
+	// The capsule goes straight to the server's transform, the mesh stays where it was drawn and catches up over the interval
+	UpdatedComponent->SetWorldLocationAndRotation(NewLocation, NewRotation, false, nullptr, ETeleportType::TeleportPhysics);
+	SetClimbMeshTransform(ClimbProxyLocation, ClimbProxyQuat);
 }
 
-bool UCustomMovementComponent::CanClimbDownLedge()
+void UCustomMovementComponent::SimulateMovement(float DeltaTime)
 {
-	if (IsFalling()) return false;
+	if (!IsClimbingSimulatedProxy())
+	{
+		Super::SimulateMovement(DeltaTime);
+		return;
+	}
 
-	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-	const FVector ComponentForward = UpdatedComponent->GetForwardVector();
-	const FVector DownVector = -UpdatedComponent->GetUpVector();
+	// Still take the server's movement mode, a climb can end without a montage (toggled off, slid off a ledge)
+	if (bNetworkUpdateReceived)
+	{
+		bNetworkUpdateReceived = false;
+
+		if (bNetworkMovementModeChanged)
+		{
+			ApplyNetworkMovementMode(CharacterOwner->GetReplicatedMovementMode());
+			bNetworkMovementModeChanged = false;
+		}
+	}
 
-	const FVector WalkableSurfaceTraceStart = ComponentLocation + ComponentForward * ClimbDownWalkableSurfaceTraceOffset;
-	const FVector WalkableSurfaceTraceEnd = WalkableSurfaceTraceStart + DownVector * 100.f;
+	// No extrapolation sweep along the wall, the proxy waits at the last replicated position
+}
 
-	FHitResult WalkableSurfaceHit = DoLineTraceSingleByObject(WalkableSurfaceTraceStart, WalkableSurfaceTraceEnd); //ds
+void UCustomMovementComponent::SmoothClientPosition(float DeltaSeconds)
+{
+	if (!IsClimbingSimulatedProxy())
+	{
+		ResetClimbProxy();
+		Super::SmoothClientPosition(DeltaSeconds);
+		return;
+	}
 
-	const FVector LedgeTraceStart = WalkableSurfaceHit.TraceStart + ComponentForward * ClimbDownLedgeTraceOffset;
-	const FVector LedgeTraceEnd = LedgeTraceStart + DownVector * 200.f;
+	if (bClimbProxyActive)
+	{
+		UpdateClimbProxy(DeltaSeconds);
+	}
+}
 
-	FHitResult LedgeTraceHit = DoLineTraceSingleByObject(LedgeTraceStart, LedgeTraceEnd); //ds
+void UCustomMovementComponent::OnClientCorrectionReceived(FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode)
+{
+	Super::OnClientCorrectionReceived(ClientData, TimeStamp, NewLocation, NewVelocity, NewBase, NewBaseBoneName, bHasBase, bBaseRelativePosition, ServerMovementMode);
 
-	if (WalkableSurfaceHit.bBlockingHit && !LedgeTraceHit.bBlockingHit)
+	if (IsClimbing())
 	{
-		return true;
+		NumClimbNetCorrections++;
+		INC_DWORD_STAT(STAT_ClimbNetCorrections);
 	}
 
-	return false;
+	// The rope isn't sent, a taut rope is as long as the server's distance to the anchor so the replays start from that
+	if (IsGrappling())
+	{
+		GrappleAnchor = GrappleRequestAnchor;
+		GrappleRopeLength = FMath::Clamp(FVector::Dist(UpdatedComponent->GetComponentLocation(), GrappleAnchor), GrappleMinLength, GrappleMaxLength);
+	}
 }
 
-void UCustomMovementComponent::StartClimbing()
+#pragma endregion
+
+#pragma region ClimbTraces
+
+// Climb traces to handle raycasts and capsule trace for climbing 
+void UCustomMovementComponent::InitClimbTraceParams()
 {
-	SetMovementMode(MOVE_Custom, ECustomMovementMode::MOVE_Climb);
+	ClimbObjectQueryParams = bTraceClimbProxiesOnly ?
+		FCollisionObjectQueryParams(ECC_Climb) :
+		FCollisionObjectQueryParams(ClimbableSurfaceTraceTypes);
+	ClimbQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(ClimbTrace), false, CharacterOwner);
+
+	ClimbDynamicQueryParams = ClimbQueryParams;
+	ClimbDynamicQueryParams.MobilityType = EQueryMobilityType::Dynamic;
+
+	ClimbHitScratch.Reserve(ClimbHitBufferReserve);
+
+	LookAheadTraceDelegate.BindUObject(this, &UCustomMovementComponent::OnLookAheadTraceDone);
 }
 
-void UCustomMovementComponent::StopClimbing()
+const FClimbSurfaceIndex* UCustomMovementComponent::FindClimbSurfaceIndex(const FBox& InQueryBounds) const
 {
-	SetMovementMode(MOVE_Falling);
+	if (!bUseBakedClimbIndex || !ClimbIndexSubsystem) return nullptr;
+
+	return ClimbIndexSubsystem->FindIndex(InQueryBounds);
 }
 
-void UCustomMovementComponent::PhysClimb(float deltaTime, int32 Iterations)
+bool UCustomMovementComponent::DoCapsuleTraceMultiByObject(const FVector& Start, const FVector& End, FClimbSurfaceSamples& OutSamples, EClimbQueryPurpose::Type Purpose, bool bShowDebugShape, bool bDrawPersistantShapes)
 {
-	if (deltaTime < MIN_TICK_TIME)
+	SCOPE_CYCLE_COUNTER(STAT_ClimbCapsuleTrace);
+
+	TArray<FHitResult>& OutHits = ClimbHitScratch;
+
+	const int32 PreviousMax = OutHits.Max();
+	OutHits.Reset();
+
+	const FBox CapsuleBounds = FBox(Start.ComponentMin(End), Start.ComponentMax(End)).ExpandBy(FVector(CapsuleTraceRadius, CapsuleTraceRadius, CapsuleTraceHalfHeight));
+	const FClimbSurfaceIndex* BakedIndex = FindClimbSurfaceIndex(CapsuleBounds);
+	const bool bLiveQuery = !BakedIndex || ClimbIndexSubsystem->OverlapsMovableClimbable(CapsuleBounds);
+
+	if (bLiveQuery)
 	{
-		return;
+		GetWorld()->SweepMultiByObjectType(
+			OutHits,
+			Start,
+			End,
+			FQuat::Identity,
+			ClimbObjectQueryParams,
+			FCollisionShape::MakeCapsule(CapsuleTraceRadius, CapsuleTraceHalfHeight),
+			BakedIndex ? ClimbDynamicQueryParams : ClimbQueryParams
+		);
 	}
 
-	// Process all the climbable surfaces info
-	TraceClimbableSurfaces();
-	ProcessClimableSurfaceInfo();
+	if (OutHits.Max() != PreviousMax)
+	{
+		NumTraceHeapAllocations++;
+		INC_DWORD_STAT(STAT_ClimbTraceHeapAllocations);
+	}
 
-	// Check if the character needs to stop climbing
-	if (CheckShouldStopClimbing() || CheckHasReachedFloor())
+	if (BakedIndex)
 	{
-		StopClimbing();
+		// The climb sweeps are a single unit long, so an overlap at the end matches them
+		BakedIndex->OverlapCapsule(End, CapsuleTraceRadius, CapsuleTraceHalfHeight, OutSamples);
+		RecordDroppedSurfaceSamples(AppendClimbSurfaceSamples(OutHits, OutSamples));
+	}
+	else
+	{
+		RecordDroppedSurfaceSamples(PackClimbSurfaceSamples(OutHits, Start, OutSamples));
 	}
 
-	RestorePreAdditiveRootMotionVelocity();
+	RecordSceneQuery(EClimbQueryShape::Capsule, Purpose, OutSamples.Num, !bLiveQuery);
 
-	if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
-	{	// Define the max climb speed and acceleration
-		CalcVelocity(deltaTime, 0.f, true, MaxBreakClimbDeceleration);
+#if ENABLE_DRAW_DEBUG
+	if (bShowDebugShape)
+	{
+		const FColor TraceColor = OutSamples.IsEmpty() ? FColor::Red : FColor::Green;
+
+		DrawDebugCapsule(GetWorld(), Start, CapsuleTraceHalfHeight, CapsuleTraceRadius, FQuat::Identity, TraceColor, bDrawPersistantShapes);
+		DrawDebugCapsule(GetWorld(), End, CapsuleTraceHalfHeight, CapsuleTraceRadius, FQuat::Identity, TraceColor, bDrawPersistantShapes);
+
+		for (int32 i = 0; i < OutSamples.Num; i++)
+		{
+			DrawDebugPoint(GetWorld(), OutSamples.GetPoint(i), 10.f, FColor::Red, bDrawPersistantShapes);
+		}
 	}
+#endif
 
-	ApplyRootMotionToVelocity(deltaTime);
+	return !OutSamples.IsEmpty();
+}
 
-	FVector OldLocation = UpdatedComponent->GetComponentLocation();
-	const FVector Adjusted = Velocity * deltaTime;
-	FHitResult Hit(1.f);
+FHitResult UCustomMovementComponent::DoLineTraceSingleByObject(const FVector& Start, const FVector& End, EClimbQueryPurpose::Type Purpose, bool bShowDebugShape, bool bDrawPersistantShapes)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ClimbLineTrace);
 
-	// Handle climb rotation
-	SafeMoveUpdatedComponent(Adjusted, GetClimbRotation(deltaTime), true, Hit);
+	FHitResult OutHit(Start, End);
 
-	if (Hit.Time < 1.f)
+	const FBox LineBounds = FBox(Start.ComponentMin(End), Start.ComponentMax(End));
+	const FClimbSurfaceIndex* BakedIndex = FindClimbSurfaceIndex(LineBounds);
+	const bool bLiveQuery = !BakedIndex || ClimbIndexSubsystem->OverlapsMovableClimbable(LineBounds);
+
+	if (bLiveQuery)
 	{
-		// Adjust and try again
-		HandleImpact(Hit, deltaTime, Adjusted);
-		SlideAlongSurface(Adjusted, (1.f - Hit.Time), Hit.Normal, Hit, true);
+		GetWorld()->LineTraceSingleByObjectType(
+			OutHit,
+			Start,
+			End,
+			ClimbObjectQueryParams,
+			BakedIndex ? ClimbDynamicQueryParams : ClimbQueryParams
+		);
 	}
 
-	if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
+	if (BakedIndex)
 	{
-		Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / deltaTime;
+		// Keep whichever is closer, the baked static geometry or the live trace against movable geometry
+		FHitResult BakedHit;
+
+		if (BakedIndex->Raycast(Start, End, BakedHit) && (!OutHit.bBlockingHit || BakedHit.Time < OutHit.Time))
+		{
+			OutHit = BakedHit;
+		}
 	}
 
-	// Snap movement to climbable surfaces
-	SnapMovementToClimableSurfaces(deltaTime);
+	RecordSceneQuery(EClimbQueryShape::Line, Purpose, OutHit.bBlockingHit ? 1 : 0, !bLiveQuery);
 
-	if (CheckHasReachedLedge())
+#if ENABLE_DRAW_DEBUG
+	if (bShowDebugShape)
 	{
-		PlayClimbMontage(ClimbToTopMontage);
+		DrawDebugLine(GetWorld(), Start, End, OutHit.bBlockingHit ? FColor::Green : FColor::Red, bDrawPersistantShapes);
+
+		if (OutHit.bBlockingHit)
+		{
+			DrawDebugPoint(GetWorld(), OutHit.ImpactPoint, 10.f, FColor::Red, bDrawPersistantShapes);
+		}
 	}
+#endif
+
+	return OutHit;
 }
 
-void UCustomMovementComponent::ProcessClimableSurfaceInfo()
+void UCustomMovementComponent::RecordSceneQuery(EClimbQueryShape::Type Shape, EClimbQueryPurpose::Type Purpose, int32 NumHits, bool bBakedIndex)
+{
+	if (SceneQueryFrame != GFrameCounter)
+	{
+		SceneQueryFrame = GFrameCounter;
+		NumSceneQueriesThisFrame = 0;
+	}
+
+	if (bBakedIndex)
+	{
+		INC_DWORD_STAT(STAT_ClimbBakedIndexQueries);
+	}
+	else
+	{
+		NumSceneQueriesThisFrame++;
+		INC_DWORD_STAT(STAT_ClimbSceneQueries);
+	}
+
+	TRACE_CLIMB_SCENE_QUERY(CharacterOwner ? CharacterOwner->GetUniqueID() : 0, Shape, Purpose, NumHits, bBakedIndex);
+}
+
+void UCustomMovementComponent::RecordDroppedSurfaceSamples(int32 InNumDropped)
+{
+	if (InNumDropped <= 0) return;
+
+	INC_DWORD_STAT_BY(STAT_ClimbDroppedSurfaceSamples, InNumDropped);
+
+	// Once per climber, a wall this dense drops hits every trace
+	UE_CLOG(NumDroppedSurfaceSamples == 0, LogClimbMovement, Warning,
+		TEXT("%s: climb trace hit more than %d surfaces, the rest were dropped"), *GetNameSafe(CharacterOwner), FClimbSurfaceSamples::Capacity);
+
+	NumDroppedSurfaceSamples += InNumDropped;
+}
+
+#pragma	endregion
+
+// Wall Running doesn't work properly, the character doesn't stick to the wall and gravity is messed up - Wall Running is disabled for now
+/*
+#pragma region Wall Run Traces 
+bool UCustomMovementComponent::TraceWallRunningSurfaces()
+{
+	FVector Start = CharacterOwner->GetActorLocation() + FVector(0, 0, 50);  // Offset start to approximate chest height
+	FVector Direction = CharacterOwner->GetActorForwardVector();
+	FVector End = Start + Direction * 1000;  // Extend the trace 1000 units in front
+
+	FHitResult HitResult;
+	FCollisionQueryParams CollisionParams;
+	CollisionParams.AddIgnoredActor(CharacterOwner);
+	GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, CollisionParams);
+
+	return HitResult.bBlockingHit && HitResult.GetActor() != nullptr; // Ensure the hit is valid and is not the player
+}
+
+#pragma endregion
+*/
+
+#pragma region Slide
+
+bool UCustomMovementComponent::CanStartSliding() const
+{
+	// Only from a run, walking into it doesn't have the speed to carry
+	return MovementMode == MOVE_Walking && Velocity.Size() >= MaxWalkSpeed;
+}
+
+void UCustomMovementComponent::StartSliding()
+{
+	Velocity = Velocity.GetSafeNormal2D() * SlideInitialSpeed;
+
+	SetMovementMode(MOVE_Custom, ECustomMovementMode::MOVE_Slide);
+}
+
+void UCustomMovementComponent::StopSliding()
+{
+	SetMovementMode(MOVE_Walking);
+}
+
+// Moves along the floor, gravity along the slope and the slide deceleration are applied to the velocity once per step
+void UCustomMovementComponent::PhysSlide(float deltaTime, int32 Iterations)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysSlide);
+
+	if (deltaTime < MIN_TICK_TIME) return;
+
+	float RemainingTime = deltaTime;
+
+	// Same substepping as walking, so leaving the floor hands the rest of the tick to the next mode
+	while (RemainingTime >= MIN_TICK_TIME && Iterations < MaxSimulationIterations)
+	{
+		Iterations++;
+		const float TimeTick = GetSimulationTimeStep(RemainingTime, Iterations);
+
+		const FVector FloorNormal = CurrentFloor.IsWalkableFloor() ? CurrentFloor.HitResult.ImpactNormal : FVector::UpVector;
+
+		const FVector SlopeAcceleration = FVector::VectorPlaneProject(FVector(0.f, 0.f, GetGravityZ()), FloorNormal) * SlideGravityScale;
+		const FVector SlideVelocity = FVector::VectorPlaneProject(Velocity, FloorNormal) + SlopeAcceleration * TimeTick;
+		const float SlideSpeed = FMath::Min(SlideVelocity.Size() - SlideDeceleration * TimeTick, SlideInitialSpeed);
+
+		if (SlideSpeed < MinSlideSpeed)
+		{
+			// Out of speed, the button has to be pressed again for the next slide
+			bWantsToSlide = false;
+			StopSliding();
+			StartNewPhysics(RemainingTime, Iterations);
+			return;
+		}
+
+		RemainingTime -= TimeTick;
+
+		Velocity = SlideVelocity.GetSafeNormal() * SlideSpeed;
+
+		const FVector Delta = Velocity * TimeTick;
+		FHitResult Hit(1.f);
+		SafeMoveUpdatedComponent(Delta, UpdatedComponent->GetComponentQuat(), true, Hit);
+
+		if (Hit.IsValidBlockingHit())
+		{
+			// SlideAlongSurface overwrites the hit with the one from the slide
+			const FVector WallNormal = Hit.Normal;
+
+			HandleImpact(Hit, TimeTick, Delta);
+			SlideAlongSurface(Delta, 1.f - Hit.Time, WallNormal, Hit, true);
+
+			// Speed into the wall is lost, a head on hit ends the slide next step
+			Velocity = FVector::VectorPlaneProject(Velocity, WallNormal);
+		}
+
+		// Follow the floor down slopes and off ledges, the velocity carries into the fall
+		FindFloor(UpdatedComponent->GetComponentLocation(), CurrentFloor, false);
+
+		if (!CurrentFloor.IsWalkableFloor())
+		{
+			SetMovementMode(MOVE_Falling);
+			StartNewPhysics(RemainingTime, Iterations);
+			return;
+		}
+
+		AdjustFloorHeight();
+		SetBaseFromFloor(CurrentFloor);
+	}
+}
+
+void UCustomMovementComponent::SetSlideCapsule(bool bSliding)
+{
+	UCapsuleComponent* Capsule = CharacterOwner ? CharacterOwner->GetCapsuleComponent() : nullptr;
+	if (!Capsule) return;
+
+	const float StandingHalfHeight = CharacterOwner->GetClass()->GetDefaultObject<ACharacter>()->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+	const float NewHalfHeight = bSliding ? SlideCapsuleHalfHeight : StandingHalfHeight;
+	const float HalfHeightDelta = (NewHalfHeight - Capsule->GetUnscaledCapsuleHalfHeight()) * Capsule->GetShapeScale();
+
+	if (FMath::IsNearlyZero(HalfHeightDelta)) return;
+
+	// No sweep or overlap update, the shrunk capsule is inside the old one and the next move updates overlaps anyway
+	Capsule->SetCapsuleHalfHeight(NewHalfHeight, false);
+	UpdatedComponent->MoveComponent(FVector(0.f, 0.f, HalfHeightDelta), UpdatedComponent->GetComponentQuat(), false, nullptr, MOVECOMP_NoFlags, ETeleportType::TeleportPhysics);
+}
+
+void UCustomMovementComponent::SetWantsToSlide(bool bInWantsToSlide)
+{
+	bWantsToSlide = bInWantsToSlide;
+}
+
+bool UCustomMovementComponent::IsSliding() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == ECustomMovementMode::MOVE_Slide;
+}
+
+bool UCustomMovementComponent::IsMovingOnGround() const
+{
+	return Super::IsMovingOnGround() || IsSliding();
+}
+
+#pragma endregion
+
+#pragma region Grapple
+
+bool UCustomMovementComponent::CanStartGrappling() const
+{
+	// Checked on the server against the anchor the client sent
+	if (FVector::DistSquared(UpdatedComponent->GetComponentLocation(), GrappleRequestAnchor) > FMath::Square(GrappleMaxLength)) return false;
+
+	// Our own aim already found the anchor, only a remote client's needs checking
+	if (CharacterOwner->GetLocalRole() == ROLE_Authority && !CharacterOwner->IsLocallyControlled())
+	{
+		return IsGrappleAnchorValid();
+	}
+
+	return true;
+}
+
+bool UCustomMovementComponent::IsGrappleAnchorValid() const
+{
+	if (const UGrappleTargetSubsystem* GrappleTargets = GetWorld()->GetSubsystem<UGrappleTargetSubsystem>())
+	{
+		if (GrappleTargets->FindTargetNear(GrappleRequestAnchor, GrappleAnchorTolerance, 1 << EGrappleTargetType::Anchor)) return true;
+	}
+
+	// Anchors on plain surfaces, the server traces to the point itself on the same channel the client aimed with
+	const FVector Start = UpdatedComponent->GetComponentLocation();
+	const FVector ToAnchor = GrappleRequestAnchor - Start;
+	const FVector End = GrappleRequestAnchor + ToAnchor.GetSafeNormal() * GrappleAnchorTolerance;
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(GrappleAnchorCheck), false, CharacterOwner);
+
+	FHitResult Hit;
+	if (!GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECC_GameTraceChannel1, Params)) return false;
+
+	return FVector::DistSquared(Hit.ImpactPoint, GrappleRequestAnchor) <= FMath::Square(GrappleAnchorTolerance);
+}
+
+void UCustomMovementComponent::StartGrappling()
+{
+	GrappleAnchor = GrappleRequestAnchor;
+	GrappleRopeLength = FMath::Max(FVector::Dist(UpdatedComponent->GetComponentLocation(), GrappleAnchor), GrappleMinLength);
+
+	if (OwningPlayerCharacter && OwningPlayerCharacter->HasAuthority())
+	{
+		OwningPlayerCharacter->SetReplicatedGrappleAnchor(GrappleAnchor);
+	}
+
+	SetMovementMode(MOVE_Custom, ECustomMovementMode::MOVE_Grapple);
+}
+
+void UCustomMovementComponent::StopGrappling()
+{
+	SetMovementMode(MOVE_Falling); // Keeps the swing's velocity
+}
+
+void UCustomMovementComponent::PhysGrapple(float deltaTime, int32 Iterations)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysGrapple);
+
+	if (deltaTime < MIN_TICK_TIME) return;
+
+	// Equal substeps, the client and server split the same move the same way
+	const int32 NumSubsteps = FMath::Clamp(FMath::CeilToInt(deltaTime / MaxGrappleSubstepSize), 1, MaxGrappleSubsteps);
+	const float SubstepTime = deltaTime / NumSubsteps;
+
+	for (int32 Substep = 0; Substep < NumSubsteps; Substep++)
+	{
+		PhysGrappleSubstep(SubstepTime);
+	}
+}
+
+// Integrates gravity and input, then solves the rope exactly by putting the capsule back on the sphere around the anchor
+void UCustomMovementComponent::PhysGrappleSubstep(float DeltaTime)
+{
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FVector RopeDirection = (GrappleAnchor - OldLocation).GetSafeNormal();
+
+	// Input towards or away from the anchor reels, input across the rope swings
+	const FVector Input = Acceleration / FMath::Max(GetMaxAcceleration(), UE_KINDA_SMALL_NUMBER);
+	const float ReelInput = FVector::DotProduct(Input, RopeDirection);
+	const FVector SwingInput = Input - RopeDirection * ReelInput;
+
+	const float ReelSpeed = GrappleReelSpeed + ReelInput * GrappleReelInputSpeed;
+	GrappleRopeLength = FMath::Clamp(GrappleRopeLength - ReelSpeed * DeltaTime, GrappleMinLength, GrappleMaxLength);
+
+	Velocity += (FVector(0.f, 0.f, GetGravityZ()) + SwingInput * GrappleSwingAcceleration) * DeltaTime;
+
+	// A slack rope doesn't pull, a taut one keeps the capsule on the sphere and takes out the speed along it
+	FVector TargetLocation = OldLocation + Velocity * DeltaTime;
+	const FVector AnchorToTarget = TargetLocation - GrappleAnchor;
+	const float TargetDistance = AnchorToTarget.Size();
+
+	if (TargetDistance > GrappleRopeLength)
+	{
+		TargetLocation = GrappleAnchor + AnchorToTarget * (GrappleRopeLength / TargetDistance);
+	}
+
+	const FVector Delta = TargetLocation - OldLocation;
+	FHitResult Hit(1.f);
+	SafeMoveUpdatedComponent(Delta, UpdatedComponent->GetComponentQuat(), true, Hit);
+
+	if (Hit.IsValidBlockingHit())
+	{
+		HandleImpact(Hit, DeltaTime, Delta);
+		SlideAlongSurface(Delta, 1.f - Hit.Time, Hit.Normal, Hit, true);
+	}
+
+	// Velocity from where the rope and collision let the capsule go
+	if (!bJustTeleported)
+	{
+		Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / DeltaTime;
+	}
+}
+
+void UCustomMovementComponent::RequestGrapple(const FVector& InAnchor)
+{
+	bWantsToGrapple = true;
+	GrappleRequestAnchor = InAnchor;
+}
+
+void UCustomMovementComponent::StopGrapple()
+{
+	bWantsToGrapple = false;
+}
+
+bool UCustomMovementComponent::IsGrappling() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == ECustomMovementMode::MOVE_Grapple;
+}
+
+FVector UCustomMovementComponent::GetGrappleAnchor() const
+{
+	if (OwningPlayerCharacter && OwningPlayerCharacter->GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		return OwningPlayerCharacter->GetReplicatedGrappleAnchor();
+	}
+
+	return GrappleAnchor;
+}
+
+float UCustomMovementComponent::GetGrappleRopeLength() const
+{
+	if (OwningPlayerCharacter && OwningPlayerCharacter->GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		return 0.f;
+	}
+
+	return GrappleRopeLength;
+}
+
+#pragma endregion
+
+#pragma region ClimbCore
+
+void UCustomMovementComponent::ToggleClimbing(bool bEnableClimb)
+{
+	if (bEnableClimb)
+	{
+		if (CanStartClimbing())
+		{
+			// Enter climb state in this move, the montage root motion carries the character onto the wall
+			StartClimbing();
+			PlayClimbMontage(IdleToClimbMontage);
+		}
+		else if (CanClimbDownLedge())
+		{
+			StartClimbing();
+			PlayClimbMontage(ClimbDownLedgeMontage);
+		}
+		else
+		{
+			TryStartVaulting(); // Check if the character can vault instead of climbing
+		}
+	}
+	
+	if(!bEnableClimb) // Toggle to stop climbing
+	{
+		StopClimbing();
+	}
+}
+
+bool UCustomMovementComponent::CanStartClimbing()
+{
+	// Checks for whether the character is falling, if the trace hits a climbable wall, and if the character is close enough to the wall
+	if (IsFalling()) return false;
+
+	ResolveEnvironmentProbes(EClimbProbe::Surface);
+	if (EnvironmentSnapshot.SurfaceSamples.IsEmpty()) return false;
+
+	ResolveEnvironmentProbes(EClimbProbe::EyeClimb);
+	if (!EnvironmentSnapshot.EyeClimbHit.bBlockingHit) return false; 
+
+	return true;
+}
+
+bool UCustomMovementComponent::CanClimbDownLedge()
+{
+	if (IsFalling()) return false;
+
+	ResolveEnvironmentProbes(EClimbProbe::ClimbDownLedge);
+
+	if (EnvironmentSnapshot.ClimbDownWalkableHit.bBlockingHit && !EnvironmentSnapshot.ClimbDownLedgeHit.bBlockingHit)
+	{
+		return true;
+	}
+
+	return false;
+}
+
+void UCustomMovementComponent::StartClimbing()
+{
+	SetMovementMode(MOVE_Custom, ECustomMovementMode::MOVE_Climb);
+}
+
+void UCustomMovementComponent::StopClimbing()
+{
+	SetMovementMode(MOVE_Falling);
+}
+
+void UCustomMovementComponent::PhysClimb(float deltaTime, int32 Iterations)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysClimb);
+
+	// Wall clock time as well as the stat, so the benchmark can read it in builds without stats
+	const double PhysClimbStartTime = FPlatformTime::Seconds();
+	ON_SCOPE_EXIT
+	{
+		if (PhysClimbFrame != GFrameCounter)
+		{
+			PhysClimbFrame = GFrameCounter;
+			PhysClimbSecondsThisFrame = 0.0;
+		}
+
+		PhysClimbSecondsThisFrame += FPlatformTime::Seconds() - PhysClimbStartTime;
+	};
+
+	if (deltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	if (ClimbLOD == EClimbLOD::Rail && PhysClimbRail(deltaTime))
+	{
+		return;
+	}
+
+	// Root motion is extracted for the whole frame, so it has to be applied over the frame's delta
+	const bool bFixedStep = bUseFixedClimbStep && FixedClimbStepSize > 0.f && !HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity();
+
+	int32 NumSteps = 0;
+
+	if (!bFixedStep)
+	{
+		ClimbStepAccumulator = 0.f;
+		ClimbPreviousStepLocation = UpdatedComponent->GetComponentLocation();
+		ClimbPreviousStepQuat = UpdatedComponent->GetComponentQuat();
+
+		PhysClimbStep(deltaTime);
+		NumSteps++;
+	}
+	else
+	{
+		// The remainder carries to the next move, the saved move restores it so replays step at the same times
+		ClimbStepAccumulator += deltaTime;
+
+		while (ClimbStepAccumulator >= FixedClimbStepSize && NumSteps < MaxClimbSubsteps && IsClimbing())
+		{
+			ClimbPreviousStepLocation = UpdatedComponent->GetComponentLocation();
+			ClimbPreviousStepQuat = UpdatedComponent->GetComponentQuat();
+
+			PhysClimbStep(FixedClimbStepSize);
+
+			ClimbStepAccumulator -= FixedClimbStepSize;
+			NumSteps++;
+		}
+
+		// Out of substeps, drop the backlog rather than falling further behind every frame
+		if (NumSteps == MaxClimbSubsteps)
+		{
+			ClimbStepAccumulator = FMath::Min(ClimbStepAccumulator, FixedClimbStepSize * 0.999f);
+		}
+	}
+
+	if (!IsClimbing()) return;
+
+	// Simulated proxies turn towards this instead of tracing for it
+	if (OwningPlayerCharacter && CharacterOwner->HasAuthority())
+	{
+		OwningPlayerCharacter->SetReplicatedClimbSurfaceNormal(CurrentClimbableSurfaceNormal);
+	}
+
+	// Draw the mesh between the last two steps by how far we are into the next one, replays only end up where the capsule is
+	if (!CharacterOwner->bClientUpdating)
+	{
+		const float StepAlpha = bFixedStep ? ClimbStepAccumulator / FixedClimbStepSize : 1.f;
+
+		SetClimbMeshTransform(
+			FMath::Lerp(ClimbPreviousStepLocation, UpdatedComponent->GetComponentLocation(), StepAlpha),
+			FQuat::Slerp(ClimbPreviousStepQuat, UpdatedComponent->GetComponentQuat(), StepAlpha));
+	}
+
+	// The look-ahead is for the next step, a move too short to step keeps the traces already in flight
+	if (!ClimbQuerySubsystem && NumSteps > 0)
+	{
+		IssueLookAheadTraces(bFixedStep ? FixedClimbStepSize : deltaTime);
+	}
+}
+
+void UCustomMovementComponent::PhysClimbStep(float deltaTime)
+{
+	// Process all the climbable surfaces info, reusing the last traces while the character is hanging still
+	if (CanReuseClimbQuery(ClimbSurfaceCache.SurfaceQuery))
+	{
+		CurrentClimbableSurfaceLocation = ClimbSurfaceCache.SurfaceLocation;
+		CurrentClimbableSurfaceNormal = ClimbSurfaceCache.SurfaceNormal;
+	}
+	else
+	{
+		if (!ConsumeLookAheadSurfaceTrace())
+		{
+			TraceClimbableSurfaces();
+			CaptureClimbQuery(ClimbSurfaceCache.SurfaceQuery, 1, ClimbHitScratch);
+		}
+
+		ProcessClimableSurfaceInfo();
+
+		ClimbSurfaceCache.SurfaceLocation = CurrentClimbableSurfaceLocation;
+		ClimbSurfaceCache.SurfaceNormal = CurrentClimbableSurfaceNormal;
+	}
+
+	// Check if the character needs to stop climbing, not while a montage is still carrying it onto the wall
+	if (!HasAnimRootMotion() && (CheckShouldStopClimbing() || CheckHasReachedFloor()))
+	{
+		StopClimbing();
+	}
+
+	RestorePreAdditiveRootMotionVelocity();
+
+	if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
+	{	// Define the max climb speed and acceleration
+		CalcVelocity(deltaTime, 0.f, true, MaxBreakClimbDeceleration);
+	}
+
+	ApplyRootMotionToVelocity(deltaTime);
+
+	// Children (mesh, cameras) and overlaps are updated once when the step's moves are done
+	{
+		FScopedMovementUpdate ScopedClimbMove(UpdatedComponent, EScopedUpdate::DeferredUpdates);
+
+		const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+
+		// Snap onto the surface as part of the same move, it's along the normal so it doesn't fight the climb velocity
+		const FVector Adjusted = Velocity * deltaTime + GetClimbSnapDelta(deltaTime);
+		FHitResult Hit(1.f);
+
+		// Handle climb rotation
+		SafeMoveUpdatedComponent(Adjusted, GetClimbRotation(deltaTime), true, Hit);
+		RecordClimbComponentMove();
+
+		if (Hit.Time < 1.f)
+		{
+			// The snap landing on the wall being climbed only slides the rest of the move along it, anything else is an impact
+			const bool bClimbSurfaceHit = FVector::DotProduct(Hit.Normal, CurrentClimbableSurfaceNormal) > 0.7f;
+
+			if (!bClimbSurfaceHit)
+			{
+				HandleImpact(Hit, deltaTime, Adjusted);
+			}
+
+			SlideAlongSurface(Adjusted, (1.f - Hit.Time), Hit.Normal, Hit, !bClimbSurfaceHit);
+			RecordClimbComponentMove();
+		}
+
+		if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
+		{
+			// Leave the snap out of the velocity, it's only the part along the surface
+			Velocity = FVector::VectorPlaneProject((UpdatedComponent->GetComponentLocation() - OldLocation) / deltaTime, CurrentClimbableSurfaceNormal);
+		}
+	}
+
+	if (CheckHasReachedLedge())
+	{
+		PlayClimbMontage(ClimbToTopMontage);
+	}
+}
+
+bool UCustomMovementComponent::PhysClimbRail(float DeltaTime)
+{
+	CalcVelocity(DeltaTime, 0.f, true, MaxBreakClimbDeceleration);
+
+	// Along the last surface plane, at the distance from it the rail started at
+	Velocity = FVector::VectorPlaneProject(Velocity, CurrentClimbableSurfaceNormal);
+
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FVector NewLocation = FVector::PointPlaneProject(OldLocation + Velocity * DeltaTime, CurrentClimbableSurfaceLocation, CurrentClimbableSurfaceNormal) +
+		CurrentClimbableSurfaceNormal * ClimbRailSurfaceDistance;
+
+	// The last traced surface is only trusted this far from where it was traced, the full climb takes over from here
+	if (FVector::DistSquared(NewLocation, ClimbRailStartLocation) > FMath::Square(ClimbLODRailMaxTravel))
+	{
+		SetClimbLOD(EClimbLOD::Full);
+		return false;
+	}
+
+	const FVector Delta = NewLocation - OldLocation;
+	const FQuat NewRotation = ClimbMath::InterpClimbRotation(UpdatedComponent->GetComponentQuat(), CurrentClimbableSurfaceNormal, DeltaTime, ClimbRotationInterpSpeed);
+
+	// Swept, so the rail can't carry us through the floor or anything that moved in front of the wall
+	FHitResult Hit;
+	SafeMoveUpdatedComponent(Delta, NewRotation, true, Hit);
+	RecordClimbComponentMove();
+
+	if (Hit.IsValidBlockingHit())
+	{
+		// Whatever we ran into isn't on the last surface, the full climb traces it and runs the floor and stop checks
+		SlideAlongSurface(Delta, 1.f - Hit.Time, Hit.Normal, Hit, true);
+		SetClimbLOD(EClimbLOD::Full);
+		return true;
+	}
+
+	// Only climbing up can reach a ledge, so the ledge traces are skipped the rest of the time
+	if (GetUnrotatedClimbVelocity().Z > 10.f && CheckHasReachedLedge())
+	{
+		PlayClimbMontage(ClimbToTopMontage);
+	}
+
+	return true;
+}
+
+float UCustomMovementComponent::UpdateClimbLOD(float DeltaTime)
+{
+	if (!IsClimbing())
+	{
+		if (ClimbLOD != EClimbLOD::Full)
+		{
+			SetClimbLOD(EClimbLOD::Full);
+		}
+
+		return DeltaTime;
+	}
+
+	const EClimbLOD::Type TargetLOD = EvaluateClimbLOD();
+
+	if (TargetLOD < ClimbLOD)
+	{
+		SetClimbLOD(TargetLOD);
+	}
+	else if (TargetLOD > ClimbLOD)
+	{
+		ClimbLODDowngradeTime += DeltaTime;
+
+		if (ClimbLODDowngradeTime >= ClimbLODDowngradeDelay)
+		{
+			SetClimbLOD(TargetLOD);
+		}
+	}
+	else
+	{
+		ClimbLODDowngradeTime = 0.f;
+	}
+
+	switch (ClimbLOD)
+	{
+	case EClimbLOD::Reduced:
+		ClimbLODAccumulatedTime += DeltaTime;
+
+		if (ClimbLODAccumulatedTime < ClimbLODReducedInterval)
+		{
+			UpdateClimbLODMeshOffset(DeltaTime);
+			return 0.f;
+		}
+		else
+		{
+			const float ReducedDeltaTime = ClimbLODAccumulatedTime;
+			ClimbLODAccumulatedTime = 0.f;
+			return ReducedDeltaTime;
+		}
+
+	case EClimbLOD::Dormant:
+		return 0.f;
+
+	default:
+		return DeltaTime;
+	}
+}
+
+EClimbLOD::Type UCustomMovementComponent::EvaluateClimbLOD() const
+{
+	if (!bEnableClimbLOD || !CharacterOwner) return EClimbLOD::Full;
+
+	// Remote climbers are only smoothed, there's nothing cheaper to drop to
+	if (IsClimbingSimulatedProxy()) return EClimbLOD::Full;
+
+	// Players notice everything, and root motion has to be simulated to end up where the animation puts us
+	if (CharacterOwner->IsPlayerControlled() || HasAnimRootMotion() || CurrentRootMotion.HasActiveRootMotionSources()) return EClimbLOD::Full;
+	if (OwningPlayerAnimInstance && OwningPlayerAnimInstance->IsAnyMontagePlaying()) return EClimbLOD::Full;
+
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	double MinDistanceSquared = MAX_dbl;
+
+	// On a server this is every player's pawn, on a client just the local views
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (!PlayerController) continue;
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(ViewLocation, ComponentLocation));
+	}
+
+	// Nobody to be significant to, e.g. a headless run without players
+	if (MinDistanceSquared == MAX_dbl) return EClimbLOD::Full;
+
+	double Distance = FMath::Sqrt(MinDistanceSquared);
+
+	// Only the local views are rendered here, a server can't tell what remote players see, so it goes by distance alone
+	const ENetMode NetMode = GetNetMode();
+	const bool bViewsRenderedHere = NetMode == NM_Standalone || NetMode == NM_Client;
+
+	if (bViewsRenderedHere && !CharacterOwner->WasRecentlyRendered(0.2f))
+	{
+		Distance *= ClimbLODOffScreenDistanceScale;
+	}
+
+	if (Distance >= ClimbLODDormantDistance) return EClimbLOD::Dormant;
+	if (Distance >= ClimbLODRailDistance) return EClimbLOD::Rail;
+	if (Distance >= ClimbLODReducedDistance) return EClimbLOD::Reduced;
+
+	return EClimbLOD::Full;
+}
+
+void UCustomMovementComponent::SetClimbLOD(EClimbLOD::Type InLOD)
+{
+	const EClimbLOD::Type PreviousLOD = ClimbLOD;
+
+	ClimbLOD = InLOD;
+	ClimbLODDowngradeTime = 0.f;
+	ClimbLODAccumulatedTime = 0.f;
+
+	// Any interpolation offset belongs to the old LOD's steps
+	ClimbLODMeshOffsetAlpha = 0.f;
+	SetClimbMeshOffset(FVector::ZeroVector);
+
+	if (InLOD == EClimbLOD::Rail)
+	{
+		ClimbRailStartLocation = UpdatedComponent->GetComponentLocation();
+		ClimbRailSurfaceDistance = FVector::DotProduct(ClimbRailStartLocation - CurrentClimbableSurfaceLocation, CurrentClimbableSurfaceNormal);
+	}
+
+	// Coming back from the rail or dormancy the cached traces are from somewhere else, PhysClimb retraces and snaps back on smoothly
+	if (PreviousLOD >= EClimbLOD::Rail && InLOD < PreviousLOD)
+	{
+		ClimbSurfaceCache.Invalidate();
+		LookAheadTraces.Invalidate();
+	}
+}
+
+void UCustomMovementComponent::UpdateClimbLODMeshOffset(float DeltaTime)
+{
+	if (ClimbLODReducedInterval > 0.f)
+	{
+		ClimbLODMeshOffsetAlpha = FMath::Max(ClimbLODMeshOffsetAlpha - DeltaTime / ClimbLODReducedInterval, 0.f);
+	}
+	else
+	{
+		ClimbLODMeshOffsetAlpha = 0.f;
+	}
+
+	SetClimbMeshOffset(ClimbLODMeshOffset * ClimbLODMeshOffsetAlpha);
+}
+
+void UCustomMovementComponent::SetClimbMeshOffset(const FVector& InWorldOffset)
+{
+	USkeletalMeshComponent* Mesh = CharacterOwner ? CharacterOwner->GetMesh() : nullptr;
+	if (!Mesh) return;
+
+	const FVector LocalOffset = UpdatedComponent->GetComponentQuat().UnrotateVector(InWorldOffset);
+
+	// Also clears any rotation the step interpolation left on the mesh
+	Mesh->SetRelativeLocationAndRotation(CharacterOwner->GetBaseTranslationOffset() + LocalOffset, CharacterOwner->GetBaseRotationOffset());
+}
+
+void UCustomMovementComponent::SetClimbMeshTransform(const FVector& InWorldLocation, const FQuat& InWorldQuat)
+{
+	USkeletalMeshComponent* Mesh = CharacterOwner ? CharacterOwner->GetMesh() : nullptr;
+	if (!Mesh) return;
+
+	const FQuat CapsuleQuat = UpdatedComponent->GetComponentQuat();
+	const FQuat LocalQuat = CapsuleQuat.Inverse() * InWorldQuat;
+	const FVector LocalOffset = CapsuleQuat.UnrotateVector(InWorldLocation - UpdatedComponent->GetComponentLocation());
+
+	Mesh->SetRelativeLocationAndRotation(
+		LocalOffset + LocalQuat.RotateVector(CharacterOwner->GetBaseTranslationOffset()),
+		LocalQuat * CharacterOwner->GetBaseRotationOffset());
+}
+
+bool UCustomMovementComponent::IsClimbingSimulatedProxy() const
+{
+	if (!CharacterOwner || CharacterOwner->GetLocalRole() != ROLE_SimulatedProxy) return false;
+
+	// Root motion montages move the proxy's capsule themselves
+	return IsClimbing() && !CharacterOwner->IsPlayingNetworkedRootMotionMontage();
+}
+
+void UCustomMovementComponent::UpdateClimbProxy(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ClimbProxySmoothing);
+
+	ClimbProxyAlpha = FMath::Min(ClimbProxyAlpha + DeltaTime / ClimbProxyUpdateInterval, 1.f);
+	ClimbProxyLocation = FMath::Lerp(ClimbProxyFromLocation, ClimbProxyToLocation, ClimbProxyAlpha);
+
+	// Turn towards the replicated surface the same way the server's GetClimbRotation does
+	const FVector ReplicatedNormal = OwningPlayerCharacter ? FVector(OwningPlayerCharacter->GetReplicatedClimbSurfaceNormal()) : FVector::ZeroVector;
+
+	if (!ReplicatedNormal.IsNearlyZero())
+	{
+		CurrentClimbableSurfaceNormal = ReplicatedNormal;
+		ClimbProxyQuat = ClimbMath::InterpClimbRotation(ClimbProxyQuat, CurrentClimbableSurfaceNormal, DeltaTime, ClimbRotationInterpSpeed);
+	}
+
+	// Off screen there's nothing to draw, the state above is kept so it's right when the mesh comes back into view
+	const USkeletalMeshComponent* Mesh = CharacterOwner->GetMesh();
+
+	if (Mesh && Mesh->bRecentlyRendered)
+	{
+		SetClimbMeshTransform(ClimbProxyLocation, ClimbProxyQuat);
+	}
+}
+
+void UCustomMovementComponent::ResetClimbProxy()
 {
-	CurrentClimbableSurfaceLocation = FVector::ZeroVector;
-	CurrentClimbableSurfaceNormal = FVector::ZeroVector;
+	if (!bClimbProxyActive) return;
 
-	if (ClimbableSurfacesTracedResults.IsEmpty()) return;
+	bClimbProxyActive = false;
 
-	for (const FHitResult& TracedHitResult : ClimbableSurfacesTracedResults)
+	if (USkeletalMeshComponent* Mesh = CharacterOwner ? CharacterOwner->GetMesh() : nullptr)
 	{
-		CurrentClimbableSurfaceLocation += TracedHitResult.ImpactPoint;
-		CurrentClimbableSurfaceNormal += TracedHitResult.ImpactNormal;
+		Mesh->SetRelativeLocationAndRotation(CharacterOwner->GetBaseTranslationOffset(), CharacterOwner->GetBaseRotationOffset());
 	}
+}
 
-	CurrentClimbableSurfaceLocation /= ClimbableSurfacesTracedResults.Num();
-	CurrentClimbableSurfaceNormal = CurrentClimbableSurfaceNormal.GetSafeNormal();
+void UCustomMovementComponent::ProcessClimableSurfaceInfo()
+{
+	FClimbPlaneFitSettings PlaneFitSettings;
+	PlaneFitSettings.WeightFalloff = PlaneFitWeightFalloff;
+	PlaneFitSettings.OutlierDistance = PlaneFitOutlierDistance;
+	PlaneFitSettings.OutlierAngleCos = FMath::Cos(FMath::DegreesToRadians(PlaneFitOutlierAngle));
+
+	FVector SurfaceLocation;
+	FVector SurfaceNormal;
+
+	// Samples closest to the capsule count the most
+	const bool bResolved = ClimbMath::ResolveSurface(
+		ClimbableSurfaceSamples,
+		bUseClimbSurfacePlaneFit,
+		UpdatedComponent->GetComponentLocation(),
+		PlaneFitSettings,
+		SurfaceLocation,
+		SurfaceNormal);
+
+	// Nothing usable to fit, keep climbing against the last good surface rather than a zero normal
+	if (!bResolved) return;
+
+	CurrentClimbableSurfaceLocation = SurfaceLocation;
+	CurrentClimbableSurfaceNormal = SurfaceNormal;
 }
 
 bool UCustomMovementComponent::CheckShouldStopClimbing()
 {
-	if (ClimbableSurfacesTracedResults.IsEmpty()) return true;
+	SCOPE_CYCLE_COUNTER(STAT_CheckShouldStopClimbing);
 
-	const float DotResult = FVector::DotProduct(CurrentClimbableSurfaceNormal, FVector::UpVector);
-	const float DegreeDiff = FMath::RadiansToDegrees(FMath::Acos(DotResult));
+	if (ClimbableSurfaceSamples.IsEmpty()) return true;
 
-	if (DegreeDiff <= 60.f) // Check for the angle of the surface
-	{
-		return true;
-	}
+	// Compare against the cosine rather than taking the Acos of the dot product every tick
+	static const float MaxClimbableSurfaceCos = FMath::Cos(FMath::DegreesToRadians(60.f));
 
-	return false;
+	return ClimbMath::IsWalkableNormal(CurrentClimbableSurfaceNormal, FVector::UpVector, MaxClimbableSurfaceCos);
 }
 
 bool UCustomMovementComponent::CheckHasReachedFloor()
 {
+	SCOPE_CYCLE_COUNTER(STAT_CheckHasReachedFloor);
+
 	const FVector DownVector = -UpdatedComponent->GetUpVector();
 	const FVector StartOffset = DownVector * 50.f;
 
 	const FVector Start = UpdatedComponent->GetComponentLocation() + StartOffset;
 	const FVector End = Start + DownVector;
 
-	TArray<FHitResult> PossibleFloorHits = DoCapsuleTraceMultiByObject(Start, End); //ds
+	if (!CanReuseClimbQuery(ClimbSurfaceCache.FloorQuery) && !ConsumeLookAheadFloorTrace())
+	{
+		DoCapsuleTraceMultiByObject(Start, End, ClimbSurfaceCache.FloorSamples, EClimbQueryPurpose::Floor); //ds
+		CaptureClimbQuery(ClimbSurfaceCache.FloorQuery, 1, ClimbHitScratch);
+	}
 
-	if (PossibleFloorHits.IsEmpty()) return false;
+	const FClimbSurfaceSamples& PossibleFloorSamples = ClimbSurfaceCache.FloorSamples;
 
-	for (const FHitResult& PossibleFloorHit : PossibleFloorHits)
-	{
-		const bool bFloorReached =
-			FVector::Parallel(-PossibleFloorHit.ImpactNormal, FVector::UpVector) &&
-			GetUnrotatedClimbVelocity().Z < -10.f;
+	if (PossibleFloorSamples.IsEmpty()) return false;
 
-		if (bFloorReached)
-		{
-			return true;
-		}
-	}
+	const bool bFloorReached =
+		GetUnrotatedClimbVelocity().Z < -10.f &&
+		PossibleFloorSamples.AnyNormalParallelTo(FVector::UpVector);
 
-	return false;
+	return bFloorReached;
 }
 
 FQuat UCustomMovementComponent::GetClimbRotation(float DeltaTime)
@@ -405,47 +1492,78 @@ FQuat UCustomMovementComponent::GetClimbRotation(float DeltaTime)
 		return CurrentQuat;
 	}
 
-	const FQuat TargetQuat = FRotationMatrix::MakeFromX(-CurrentClimbableSurfaceNormal).ToQuat();
-
-	return FMath::QInterpTo(CurrentQuat, TargetQuat, DeltaTime, 5.f);
+	return ClimbMath::InterpClimbRotation(CurrentQuat, CurrentClimbableSurfaceNormal, DeltaTime, ClimbRotationInterpSpeed);
 }
 
-void UCustomMovementComponent::SnapMovementToClimableSurfaces(float DeltaTime)
+FVector UCustomMovementComponent::GetClimbSnapDelta(float DeltaTime) const
 {
-	const FVector ComponentForward = UpdatedComponent->GetForwardVector();
-	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-
-	const FVector ProjectedCharacterToSurface =
-		(CurrentClimbableSurfaceLocation - ComponentLocation).ProjectOnTo(ComponentForward);
+	SCOPE_CYCLE_COUNTER(STAT_GetClimbSnapDelta);
+
+	return ClimbMath::GetSnapDelta(
+		CurrentClimbableSurfaceLocation,
+		CurrentClimbableSurfaceNormal,
+		UpdatedComponent->GetComponentLocation(),
+		UpdatedComponent->GetForwardVector(),
+		DeltaTime,
+		MaxClimbSpeed);
+}
 
-	const FVector SnapVector = -CurrentClimbableSurfaceNormal * ProjectedCharacterToSurface.Length();
+void UCustomMovementComponent::RecordClimbComponentMove()
+{
+	if (ComponentMoveFrame != GFrameCounter)
+	{
+		ComponentMoveFrame = GFrameCounter;
+		NumComponentMovesThisFrame = 0;
+	}
 
-	UpdatedComponent->MoveComponent(
-		SnapVector * DeltaTime * MaxClimbSpeed,
-		UpdatedComponent->GetComponentQuat(),
-		true);
+	NumComponentMovesThisFrame++;
+	INC_DWORD_STAT(STAT_ClimbComponentMoves);
 }
 
 bool UCustomMovementComponent::CheckHasReachedLedge()
 {
-	FHitResult LedgetHitResult = TraceFromEyeHeight(100.f, 50.f);
+	SCOPE_CYCLE_COUNTER(STAT_CheckHasReachedLedge);
 
-	if (!LedgetHitResult.bBlockingHit)
+	if (const FClimbHopCell* HopCell = FindClimbHopCell())
 	{
-		const FVector WalkableSurfaceTraceStart = LedgetHitResult.TraceEnd;
+		return HopCell->bCanMantle && GetUnrotatedClimbVelocity().Z > 10.f;
+	}
 
-		const FVector DownVector = -UpdatedComponent->GetUpVector();
-		const FVector WalkableSurfaceTraceEnd = WalkableSurfaceTraceStart + DownVector * 100.f;
+	if (!CanReuseClimbQuery(ClimbSurfaceCache.LedgeQuery) && !ConsumeLookAheadLedgeTraces())
+	{
+		ClimbSurfaceCache.LedgeHit = TraceFromEyeHeight(EClimbQueryPurpose::Ledge, 100.f, 50.f);
+		ClimbSurfaceCache.LedgeWalkableHit.Reset();
+
+		int32 NumSceneQueries = 1;
+
+		if (!ClimbSurfaceCache.LedgeHit.bBlockingHit)
+		{
+			const FVector WalkableSurfaceTraceStart = ClimbSurfaceCache.LedgeHit.TraceEnd;
+
+			const FVector DownVector = -UpdatedComponent->GetUpVector();
+			const FVector WalkableSurfaceTraceEnd = WalkableSurfaceTraceStart + DownVector * 100.f;
 
-		FHitResult WalkableSurfaceHitResult =
-			DoLineTraceSingleByObject(WalkableSurfaceTraceStart, WalkableSurfaceTraceEnd); //ds
+			ClimbSurfaceCache.LedgeWalkableHit =
+				DoLineTraceSingleByObject(WalkableSurfaceTraceStart, WalkableSurfaceTraceEnd, EClimbQueryPurpose::LedgeWalkable); //ds
+
+			++NumSceneQueries;
+		}
+
+		const FHitResult LedgeHits[] = { ClimbSurfaceCache.LedgeHit, ClimbSurfaceCache.LedgeWalkableHit };
+		CaptureClimbQuery(ClimbSurfaceCache.LedgeQuery, NumSceneQueries, LedgeHits);
+	}
+
+	const FHitResult& LedgetHitResult = ClimbSurfaceCache.LedgeHit;
+
+	if (!LedgetHitResult.bBlockingHit)
+	{
+		const FHitResult& WalkableSurfaceHitResult = ClimbSurfaceCache.LedgeWalkableHit;
 
 		if (WalkableSurfaceHitResult.bBlockingHit && GetUnrotatedClimbVelocity().Z > 10.f)
 		{
-			const float DotResult = FVector::DotProduct(WalkableSurfaceHitResult.ImpactNormal, FVector::UpVector);
-			const float DegreeDifference = FMath::RadiansToDegrees(FMath::Acos(DotResult));
+			static const float MaxWalkableSurfaceCos = FMath::Cos(FMath::DegreesToRadians(60.f));
 
-			if (DegreeDifference <= 60.f)
+			if (ClimbMath::IsWalkableNormal(WalkableSurfaceHitResult.ImpactNormal, FVector::UpVector, MaxWalkableSurfaceCos))
 			{
 				return true;
 			}
@@ -480,77 +1598,452 @@ bool UCustomMovementComponent::CanStartVaulting(FVector& OutVaultStartPosition,
 {
 	if (IsFalling()) return false;
 
-	OutVaultStartPosition = FVector::ZeroVector;
-	OutVaultEndPosition = FVector::ZeroVector;
+	ResolveEnvironmentProbes(EClimbProbe::Vault);
+
+	const FHitResult& VaultStartHit = EnvironmentSnapshot.VaultHits[0];
+	const FHitResult& VaultEndHit = EnvironmentSnapshot.VaultHits[FClimbEnvironmentSnapshot::NumVaultSamples - 1]; // At which point should the character land
+
+	return ClimbMath::EvaluateVault(
+		VaultStartHit.bBlockingHit, VaultStartHit.ImpactPoint,
+		VaultEndHit.bBlockingHit, VaultEndHit.ImpactPoint,
+		OutVaultStartPosition, OutVaultEndPosition);
+}
+
+bool UCustomMovementComponent::IsClimbing() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == ECustomMovementMode::MOVE_Climb;
+}
+
+// Trace for climbable surfaces, return true if there valid walls
+bool UCustomMovementComponent::TraceClimbableSurfaces()
+{
+	SCOPE_CYCLE_COUNTER(STAT_TraceClimbableSurfaces);
+
+	const FVector StartOffset = UpdatedComponent->GetForwardVector() * 30.f;
+	const FVector Start = UpdatedComponent->GetComponentLocation() + StartOffset;
+	const FVector End = Start + UpdatedComponent->GetForwardVector();
+
+	return DoCapsuleTraceMultiByObject(Start, End, ClimbableSurfaceSamples, EClimbQueryPurpose::Surface); //ds
+}
+
+FHitResult UCustomMovementComponent::TraceFromEyeHeight(EClimbQueryPurpose::Type Purpose, float TraceDistance, float TraceStartOffset, bool bShowDebugShape, bool bDrawPersistantShapes)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TraceFromEyeHeight);
+
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const FVector EyeHeightOffset = UpdatedComponent->GetUpVector() * (CharacterOwner->BaseEyeHeight + TraceStartOffset);
+
+	const FVector Start = ComponentLocation + EyeHeightOffset;
+	const FVector End = Start + UpdatedComponent->GetForwardVector() * TraceDistance;
+
+	return DoLineTraceSingleByObject(Start, End, Purpose, bShowDebugShape, bDrawPersistantShapes); //ds
+}
 
+void UCustomMovementComponent::ResolveEnvironmentProbes(uint8 InProbes)
+{
 	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const FQuat ComponentQuat = UpdatedComponent->GetComponentQuat();
+
+	// Start a new snapshot once per frame, or if the capsule has been moved since the probes were taken
+	if (!EnvironmentSnapshot.IsValidFor(GFrameCounter, ComponentLocation, ComponentQuat))
+	{
+		EnvironmentSnapshot.Reset(GFrameCounter, ComponentLocation, ComponentQuat);
+	}
+
+	const uint8 MissingProbes = InProbes & ~EnvironmentSnapshot.ProbedMask;
+	if (MissingProbes == 0) return;
+
 	const FVector ComponentForward = UpdatedComponent->GetForwardVector();
 	const FVector UpVector = UpdatedComponent->GetUpVector();
-	const FVector DownVector = -UpdatedComponent->GetUpVector();
+	const FVector DownVector = -UpVector;
 
-	for (int32 i = 0; i < 5; i++)
+	if (MissingProbes & EClimbProbe::Surface)
 	{
-		const FVector Start = ComponentLocation + UpVector * 100.f +
-			ComponentForward * 80.f * (i + 1);
+		const FVector Start = ComponentLocation + ComponentForward * 30.f;
+		const FVector End = Start + ComponentForward;
 
-		const FVector End = Start + DownVector * 100.f * (i + 1);
+		DoCapsuleTraceMultiByObject(Start, End, EnvironmentSnapshot.SurfaceSamples, EClimbQueryPurpose::Surface); //ds
+	}
 
-		FHitResult VaultTraceHit = DoLineTraceSingleByObject(Start, End); //ds
+	if (MissingProbes & EClimbProbe::EyeClimb)
+	{
+		EnvironmentSnapshot.EyeClimbHit = TraceFromEyeHeight(EClimbQueryPurpose::EyeClimb, 100.f);
+	}
 
-		if (i == 0 && VaultTraceHit.bBlockingHit)
-		{
-			OutVaultStartPosition = VaultTraceHit.ImpactPoint;
-		}
+	if (MissingProbes & EClimbProbe::EyeHopUp)
+	{
+		EnvironmentSnapshot.EyeHopUpHit = TraceFromEyeHeight(EClimbQueryPurpose::EyeHopUp, 100.f, -20.f);
+	}
+
+	if (MissingProbes & EClimbProbe::EyeSafetyLedge)
+	{
+		EnvironmentSnapshot.EyeSafetyLedgeHit = TraceFromEyeHeight(EClimbQueryPurpose::EyeSafetyLedge, 100.f, 150.f);
+	}
+
+	if (MissingProbes & EClimbProbe::EyeHopDown)
+	{
+		EnvironmentSnapshot.EyeHopDownHit = TraceFromEyeHeight(EClimbQueryPurpose::EyeHopDown, 100.f, -300.f);
+	}
+
+	if (MissingProbes & EClimbProbe::ClimbDownLedge)
+	{
+		const FVector WalkableSurfaceTraceStart = ComponentLocation + ComponentForward * ClimbDownWalkableSurfaceTraceOffset;
+		const FVector WalkableSurfaceTraceEnd = WalkableSurfaceTraceStart + DownVector * 100.f;
+
+		EnvironmentSnapshot.ClimbDownWalkableHit = DoLineTraceSingleByObject(WalkableSurfaceTraceStart, WalkableSurfaceTraceEnd, EClimbQueryPurpose::ClimbDownWalkable); //ds
+
+		const FVector LedgeTraceStart = WalkableSurfaceTraceStart + ComponentForward * ClimbDownLedgeTraceOffset;
+		const FVector LedgeTraceEnd = LedgeTraceStart + DownVector * 200.f;
+
+		EnvironmentSnapshot.ClimbDownLedgeHit = DoLineTraceSingleByObject(LedgeTraceStart, LedgeTraceEnd, EClimbQueryPurpose::ClimbDownLedge); //ds
+	}
+
+	if (MissingProbes & EClimbProbe::Vault)
+	{
+		const ClimbMath::FVaultPattern VaultPattern;
 
-		if (i == 4 && VaultTraceHit.bBlockingHit) // At which point should the character land
+		for (int32 i = 0; i < FClimbEnvironmentSnapshot::NumVaultSamples; i++)
 		{
-			OutVaultEndPosition = VaultTraceHit.ImpactPoint;
+			FVector Start, End;
+			ClimbMath::GetVaultSample(ComponentLocation, ComponentForward, UpVector, VaultPattern, i, Start, End);
+
+			EnvironmentSnapshot.VaultHits[i] = DoLineTraceSingleByObject(Start, End, EClimbQueryPurpose::Vault); //ds
 		}
 	}
 
-	if (OutVaultStartPosition != FVector::ZeroVector && OutVaultEndPosition != FVector::ZeroVector)
+	EnvironmentSnapshot.ProbedMask |= MissingProbes;
+}
+
+bool UCustomMovementComponent::CanReuseClimbQuery(const FClimbCachedQuery& InQuery)
+{
+	// Over the frame's query budget, keep the last results, the batch stops throttling us once they're too old or too far away
+	if (ClimbQueryThrottledFrame == GFrameCounter && InQuery.bValid)
 	{
+		ClimbSurfaceCache.NumHits++;
+		ClimbSurfaceCache.NumSavedSceneQueries += InQuery.NumSceneQueries;
 		return true;
 	}
+
+	if (!bEnableClimbTraceCache) return false;
+
+	const bool bReusable = InQuery.IsReusable(
+		UpdatedComponent->GetComponentLocation(),
+		UpdatedComponent->GetComponentQuat(),
+		ClimbTraceCacheMaxDistance,
+		ClimbTraceCacheMaxAngle);
+
+	if (bReusable)
+	{
+		ClimbSurfaceCache.NumHits++;
+		ClimbSurfaceCache.NumSavedSceneQueries += InQuery.NumSceneQueries;
+	}
 	else
 	{
+		ClimbSurfaceCache.NumMisses++;
+	}
+
+	return bReusable;
+}
+
+void UCustomMovementComponent::CaptureClimbQuery(FClimbCachedQuery& InQuery, int32 InNumSceneQueries, TConstArrayView<FHitResult> InHits)
+{
+	InQuery.Capture(UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentQuat(), InNumSceneQueries);
+
+	for (const FHitResult& Hit : InHits)
+	{
+		InQuery.TrackHit(Hit);
+	}
+}
+
+void UCustomMovementComponent::IssueLookAheadTraces(float DeltaTime)
+{
+	LookAheadTraces.Invalidate();
+
+	if (!bUseAsyncLookAheadTraces) return;
+
+	UWorld* World = GetWorld();
+	if (!World) return;
+
+	const FQuat ComponentQuat = UpdatedComponent->GetComponentQuat();
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+
+	// Inside a baked index the synchronous checks are already cheap, nothing to get ahead of
+	if (FindClimbSurfaceIndex(FBox::BuildAABB(ComponentLocation, FVector(CharacterOwner->BaseEyeHeight + 200.f)))) return;
+	const FVector ComponentForward = ComponentQuat.GetForwardVector();
+	const FVector UpVector = ComponentQuat.GetUpVector();
+	const FVector DownVector = -UpVector;
+
+	// The floor is checked before next tick's move and the ledge after it
+	const FVector FloorLocation = ComponentLocation;
+	const FVector LedgeLocation = ComponentLocation + Velocity * DeltaTime;
+
+	// Only trace what next tick's checks will actually read, hanging still they reuse the cached results instead
+	const bool bNeedsFloor = !WillReuseClimbQuery(ClimbSurfaceCache.FloorQuery, FloorLocation, ComponentQuat);
+	const bool bNeedsLedge = !WillReuseClimbQuery(ClimbSurfaceCache.LedgeQuery, LedgeLocation, ComponentQuat);
+
+	if (!bNeedsFloor && !bNeedsLedge) return;
+
+	LookAheadTraces.FloorLocation = FloorLocation;
+	LookAheadTraces.LedgeLocation = LedgeLocation;
+	LookAheadTraces.Rotation = ComponentQuat;
+	LookAheadTraces.UsableFrame = GFrameCounter + 1;
+
+	if (bNeedsFloor)
+	{
+		const FVector FloorTraceStart = FloorLocation + DownVector * 50.f;
+
+		LookAheadTraces.FloorHandle = World->AsyncSweepByObjectType(
+			EAsyncTraceType::Multi,
+			FloorTraceStart,
+			FloorTraceStart + DownVector,
+			FQuat::Identity,
+			ClimbObjectQueryParams,
+			FCollisionShape::MakeCapsule(CapsuleTraceRadius, CapsuleTraceHalfHeight),
+			ClimbQueryParams,
+			&LookAheadTraceDelegate,
+			EClimbLookAheadTrace::Floor);
+
+		LookAheadTraces.bFloorPending = true;
+	}
+
+	if (bNeedsLedge)
+	{
+		// Same as TraceFromEyeHeight(100.f, 50.f), plus the walkable surface trace that follows it when it misses
+		const FVector LedgeTraceStart = LedgeLocation + UpVector * (CharacterOwner->BaseEyeHeight + 50.f);
+		const FVector LedgeTraceEnd = LedgeTraceStart + ComponentForward * 100.f;
+
+		LookAheadTraces.LedgeHandle = World->AsyncLineTraceByObjectType(
+			EAsyncTraceType::Single, LedgeTraceStart, LedgeTraceEnd, ClimbObjectQueryParams, ClimbQueryParams,
+			&LookAheadTraceDelegate, EClimbLookAheadTrace::Ledge);
+
+		LookAheadTraces.LedgeWalkableHandle = World->AsyncLineTraceByObjectType(
+			EAsyncTraceType::Single, LedgeTraceEnd, LedgeTraceEnd + DownVector * 100.f, ClimbObjectQueryParams, ClimbQueryParams,
+			&LookAheadTraceDelegate, EClimbLookAheadTrace::LedgeWalkable);
+
+		LookAheadTraces.bLedgePending = true;
+	}
+}
+
+bool UCustomMovementComponent::WillReuseClimbQuery(const FClimbCachedQuery& InQuery, const FVector& InLocation, const FQuat& InQuat) const
+{
+	return bEnableClimbTraceCache && InQuery.IsReusable(InLocation, InQuat, ClimbTraceCacheMaxDistance, ClimbTraceCacheMaxAngle);
+}
+
+bool UCustomMovementComponent::CanUseLookAheadTrace(bool bPending, const FVector& InPredictedLocation) const
+{
+	if (!bPending) return false;
+	if (LookAheadTraces.UsableFrame != GFrameCounter) return false;
+
+	const FQuat ComponentQuat = UpdatedComponent->GetComponentQuat();
+
+	if (FVector::DistSquared(UpdatedComponent->GetComponentLocation(), InPredictedLocation) > FMath::Square(LookAheadMaxDistanceError)) return false;
+	if (FMath::RadiansToDegrees(ComponentQuat.AngularDistance(LookAheadTraces.Rotation)) > LookAheadMaxAngleError) return false;
+
+	return true;
+}
+
+void UCustomMovementComponent::OnLookAheadTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	// Copy into our own buffers so consuming the results doesn't allocate, and ignore traces that have been superseded
+	switch (TraceDatum.UserData)
+	{
+	case EClimbLookAheadTrace::Floor:
+		if (TraceHandle != LookAheadTraces.FloorHandle) return;
+		RecordSceneQuery(EClimbQueryShape::Capsule, EClimbQueryPurpose::LookAheadFloor, TraceDatum.OutHits.Num(), false);
+		RecordDroppedSurfaceSamples(PackClimbSurfaceSamples(TraceDatum.OutHits, TraceDatum.Start, LookAheadTraces.FloorSamples));
+		LookAheadTraces.FloorQuery.Capture(LookAheadTraces.FloorLocation, LookAheadTraces.Rotation, 1);
+		for (const FHitResult& Hit : TraceDatum.OutHits)
+		{
+			LookAheadTraces.FloorQuery.TrackHit(Hit);
+		}
+		LookAheadTraces.bFloorReady = true;
+		break;
+
+	case EClimbLookAheadTrace::Ledge:
+		if (TraceHandle != LookAheadTraces.LedgeHandle) return;
+		RecordSceneQuery(EClimbQueryShape::Line, EClimbQueryPurpose::LookAheadLedge, TraceDatum.OutHits.Num(), false);
+		// Single traces only return a hit when they block, otherwise keep the trace ends like the synchronous path does
+		LookAheadTraces.LedgeHit = TraceDatum.OutHits.IsEmpty() ? FHitResult(TraceDatum.Start, TraceDatum.End) : TraceDatum.OutHits[0];
+		LookAheadTraces.bLedgeReady = true;
+		break;
+
+	case EClimbLookAheadTrace::LedgeWalkable:
+		if (TraceHandle != LookAheadTraces.LedgeWalkableHandle) return;
+		RecordSceneQuery(EClimbQueryShape::Line, EClimbQueryPurpose::LookAheadLedgeWalkable, TraceDatum.OutHits.Num(), false);
+		LookAheadTraces.LedgeWalkableHit = TraceDatum.OutHits.IsEmpty() ? FHitResult(TraceDatum.Start, TraceDatum.End) : TraceDatum.OutHits[0];
+		LookAheadTraces.bLedgeWalkableReady = true;
+		break;
+	}
+}
+
+bool UCustomMovementComponent::ConsumeLookAheadSurfaceTrace()
+{
+	const bool bCanUse = CanUseLookAheadTrace(LookAheadTraces.bSurfacePending, LookAheadTraces.FloorLocation);
+	const bool bWasPending = LookAheadTraces.bSurfacePending;
+	LookAheadTraces.bSurfacePending = false;
+
+	if (!bCanUse || !LookAheadTraces.bSurfaceReady)
+	{
+		if (bWasPending) LookAheadTraces.NumPredictionFallbacks++;
 		return false;
 	}
 
+	ClimbableSurfaceSamples = LookAheadTraces.SurfaceSamples;
+	CaptureClimbQuery(ClimbSurfaceCache.SurfaceQuery, 1, TConstArrayView<FHitResult>());
+	ClimbSurfaceCache.SurfaceQuery.Primitives = LookAheadTraces.SurfaceQuery.Primitives;
+
+	LookAheadTraces.NumPredictionsUsed++;
+	return true;
 }
 
-bool UCustomMovementComponent::IsClimbing() const
+bool UCustomMovementComponent::ConsumeLookAheadFloorTrace()
 {
-	return MovementMode == MOVE_Custom && CustomMovementMode == ECustomMovementMode::MOVE_Climb;
+	const bool bCanUse = CanUseLookAheadTrace(LookAheadTraces.bFloorPending, LookAheadTraces.FloorLocation);
+	const bool bWasPending = LookAheadTraces.bFloorPending;
+	LookAheadTraces.bFloorPending = false;
+
+	if (!bCanUse || !LookAheadTraces.bFloorReady)
+	{
+		if (bWasPending) LookAheadTraces.NumPredictionFallbacks++;
+		return false;
+	}
+
+	ClimbSurfaceCache.FloorSamples = LookAheadTraces.FloorSamples;
+	CaptureClimbQuery(ClimbSurfaceCache.FloorQuery, 1, TConstArrayView<FHitResult>());
+	ClimbSurfaceCache.FloorQuery.Primitives = LookAheadTraces.FloorQuery.Primitives;
+
+	LookAheadTraces.NumPredictionsUsed++;
+	return true;
 }
 
-// Trace for climbable surfaces, return true if there valid walls
-bool UCustomMovementComponent::TraceClimbableSurfaces()
+bool UCustomMovementComponent::ConsumeLookAheadLedgeTraces()
 {
-	const FVector StartOffset = UpdatedComponent->GetForwardVector() * 30.f;
-	const FVector Start = UpdatedComponent->GetComponentLocation() + StartOffset;
-	const FVector End = Start + UpdatedComponent->GetForwardVector();
+	const bool bCanUse = CanUseLookAheadTrace(LookAheadTraces.bLedgePending, LookAheadTraces.LedgeLocation);
+	const bool bWasPending = LookAheadTraces.bLedgePending;
+	LookAheadTraces.bLedgePending = false;
+
+	if (!bCanUse || !LookAheadTraces.bLedgeReady || !LookAheadTraces.bLedgeWalkableReady)
+	{
+		if (bWasPending) LookAheadTraces.NumPredictionFallbacks++;
+		return false;
+	}
+
+	ClimbSurfaceCache.LedgeHit = LookAheadTraces.LedgeHit;
+	ClimbSurfaceCache.LedgeWalkableHit.Reset();
+
+	if (!ClimbSurfaceCache.LedgeHit.bBlockingHit)
+	{
+		ClimbSurfaceCache.LedgeWalkableHit = LookAheadTraces.LedgeWalkableHit;
+	}
 
-	ClimbableSurfacesTracedResults = DoCapsuleTraceMultiByObject(Start, End); //ds
+	const FHitResult LedgeHits[] = { ClimbSurfaceCache.LedgeHit, ClimbSurfaceCache.LedgeWalkableHit };
+	CaptureClimbQuery(ClimbSurfaceCache.LedgeQuery, 2, LedgeHits);
 
-	return !ClimbableSurfacesTracedResults.IsEmpty();
+	LookAheadTraces.NumPredictionsUsed++;
+	return true;
 }
 
-FHitResult UCustomMovementComponent::TraceFromEyeHeight(float TraceDistance, float TraceStartOffset, bool bShowDebugShape, bool bDrawPersistantShapes)
+bool UCustomMovementComponent::PrepareBatchedClimbQuery(FClimbBatchedQuery& OutQuery, float DeltaTime)
 {
+	if (!IsClimbing() || !UpdatedComponent || !CharacterOwner) return false;
+
+	// Only climbers that will run a traced PhysClimb this tick
+	if (ClimbLOD == EClimbLOD::Rail || ClimbLOD == EClimbLOD::Dormant) return false;
+	if (ClimbLOD == EClimbLOD::Reduced && ClimbLODAccumulatedTime + DeltaTime < ClimbLODReducedInterval) return false;
+
+	const FQuat ComponentQuat = UpdatedComponent->GetComponentQuat();
 	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-	const FVector EyeHeightOffset = UpdatedComponent->GetUpVector() * (CharacterOwner->BaseEyeHeight + TraceStartOffset);
 
-	const FVector Start = ComponentLocation + EyeHeightOffset;
-	const FVector End = Start + UpdatedComponent->GetForwardVector() * TraceDistance;
+	// Inside a baked index the synchronous checks are already cheap, leave the budget to everyone else
+	if (FindClimbSurfaceIndex(FBox::BuildAABB(ComponentLocation, FVector(CharacterOwner->BaseEyeHeight + 200.f)))) return false;
+
+	// Hanging still on results the trace cache will reuse anyway
+	if (bEnableClimbTraceCache && Velocity.IsNearlyZero() &&
+		ClimbSurfaceCache.SurfaceQuery.IsReusable(ComponentLocation, ComponentQuat, ClimbTraceCacheMaxDistance, ClimbTraceCacheMaxAngle) &&
+		ClimbSurfaceCache.FloorQuery.IsReusable(ComponentLocation, ComponentQuat, ClimbTraceCacheMaxDistance, ClimbTraceCacheMaxAngle) &&
+		ClimbSurfaceCache.LedgeQuery.IsReusable(ComponentLocation, ComponentQuat, ClimbTraceCacheMaxDistance, ClimbTraceCacheMaxAngle))
+	{
+		LastBatchedClimbQueryFrame = GFrameCounter;
+		LastBatchedClimbQueryLocation = ComponentLocation;
+		return false;
+	}
 
-	return DoLineTraceSingleByObject(Start, End, bShowDebugShape, bDrawPersistantShapes); //ds
+	const FVector ComponentForward = ComponentQuat.GetForwardVector();
+	const FVector UpVector = ComponentQuat.GetUpVector();
+	const FVector DownVector = -UpVector;
+
+	// Same traces as TraceClimbableSurfaces, CheckHasReachedFloor and CheckHasReachedLedge, from where this tick's checks will run
+	const float StepTime = bUseFixedClimbStep && FixedClimbStepSize > 0.f ? FixedClimbStepSize : DeltaTime;
+	const FVector LedgeLocation = ComponentLocation + Velocity * StepTime;
+
+	OutQuery.StaleFrames = GFrameCounter - LastBatchedClimbQueryFrame;
+	OutQuery.StaleDistance = FVector::Dist(ComponentLocation, LastBatchedClimbQueryLocation);
+	OutQuery.ObjectQueryParams = &ClimbObjectQueryParams;
+	OutQuery.QueryParams = &ClimbQueryParams;
+	OutQuery.Capsule = FCollisionShape::MakeCapsule(CapsuleTraceRadius, CapsuleTraceHalfHeight);
+
+	OutQuery.SurfaceStart = ComponentLocation + ComponentForward * 30.f;
+	OutQuery.SurfaceEnd = OutQuery.SurfaceStart + ComponentForward;
+
+	OutQuery.FloorStart = ComponentLocation + DownVector * 50.f;
+	OutQuery.FloorEnd = OutQuery.FloorStart + DownVector;
+
+	OutQuery.LedgeStart = LedgeLocation + UpVector * (CharacterOwner->BaseEyeHeight + 50.f);
+	OutQuery.LedgeEnd = OutQuery.LedgeStart + ComponentForward * 100.f;
+	OutQuery.LedgeWalkableEnd = OutQuery.LedgeEnd + DownVector * 100.f;
+
+	LookAheadTraces.Invalidate();
+	LookAheadTraces.FloorLocation = ComponentLocation;
+	LookAheadTraces.LedgeLocation = LedgeLocation;
+	LookAheadTraces.Rotation = ComponentQuat;
+
+	return true;
+}
+
+void UCustomMovementComponent::ApplyBatchedClimbQuery(const FClimbBatchedQuery& InQuery)
+{
+	LastBatchedClimbQueryFrame = GFrameCounter;
+	LastBatchedClimbQueryLocation = LookAheadTraces.FloorLocation;
+
+	LookAheadTraces.UsableFrame = GFrameCounter;
+
+	RecordDroppedSurfaceSamples(PackClimbSurfaceSamples(InQuery.SurfaceHits, InQuery.SurfaceStart, LookAheadTraces.SurfaceSamples));
+	LookAheadTraces.SurfaceQuery.Capture(LookAheadTraces.FloorLocation, LookAheadTraces.Rotation, 1);
+	for (const FHitResult& Hit : InQuery.SurfaceHits)
+	{
+		LookAheadTraces.SurfaceQuery.TrackHit(Hit);
+	}
+
+	RecordDroppedSurfaceSamples(PackClimbSurfaceSamples(InQuery.FloorHits, InQuery.FloorStart, LookAheadTraces.FloorSamples));
+	LookAheadTraces.FloorQuery.Capture(LookAheadTraces.FloorLocation, LookAheadTraces.Rotation, 1);
+	for (const FHitResult& Hit : InQuery.FloorHits)
+	{
+		LookAheadTraces.FloorQuery.TrackHit(Hit);
+	}
+
+	LookAheadTraces.LedgeHit = InQuery.LedgeHit;
+	LookAheadTraces.LedgeWalkableHit = InQuery.LedgeWalkableHit;
+
+	LookAheadTraces.bSurfacePending = LookAheadTraces.bSurfaceReady = true;
+	LookAheadTraces.bFloorPending = LookAheadTraces.bFloorReady = true;
+	LookAheadTraces.bLedgePending = LookAheadTraces.bLedgeReady = LookAheadTraces.bLedgeWalkableReady = true;
+
+	RecordSceneQuery(EClimbQueryShape::Capsule, EClimbQueryPurpose::Surface, InQuery.SurfaceHits.Num(), false);
+	RecordSceneQuery(EClimbQueryShape::Capsule, EClimbQueryPurpose::LookAheadFloor, InQuery.FloorHits.Num(), false);
+	RecordSceneQuery(EClimbQueryShape::Line, EClimbQueryPurpose::LookAheadLedge, InQuery.LedgeHit.bBlockingHit ? 1 : 0, false);
+	RecordSceneQuery(EClimbQueryShape::Line, EClimbQueryPurpose::LookAheadLedgeWalkable, InQuery.LedgeWalkableHit.bBlockingHit ? 1 : 0, false);
+}
+
+void UCustomMovementComponent::ThrottleClimbQueries()
+{
+	ClimbQueryThrottledFrame = GFrameCounter;
 }
 
 void UCustomMovementComponent::PlayClimbMontage(UAnimMontage* MontageToPlay)
 {
 	if (!MontageToPlay) return;
 	if (!OwningPlayerAnimInstance) return;
+	if (CharacterOwner && CharacterOwner->bClientUpdating) return; // Replayed moves don't play montages again
 	if (OwningPlayerAnimInstance->IsAnyMontagePlaying()) return;
 
 	OwningPlayerAnimInstance->Montage_Play(MontageToPlay);
@@ -558,25 +2051,30 @@ void UCustomMovementComponent::PlayClimbMontage(UAnimMontage* MontageToPlay)
 
 void UCustomMovementComponent::OnClimbMontageEnded(UAnimMontage* Montage, bool bInterrupted)
 {
-	if (Montage == IdleToClimbMontage || Montage == ClimbDownLedgeMontage)
-	{
-		StartClimbing();
-		StopMovementImmediately();
-	}
-
 	if (Montage == ClimbToTopMontage || Montage == VaultMontage)
 	{
 		SetMovementMode(MOVE_Walking);
 	}
 }
 
+void UCustomMovementComponent::RequestClimbToggle()
+{
+	bWantsToClimb = !IsClimbing();
+}
+
 void UCustomMovementComponent::RequestHopping()
 {
-	const FVector UnrotatedLastInputVector =
-		UKismetMathLibrary::Quat_UnrotateVector(UpdatedComponent->GetComponentQuat(), GetLastInputVector());
+	bWantsToHop = true;
+}
+
+void UCustomMovementComponent::HandleHopRequest()
+{
+	// Acceleration rather than the last input, it's what the server has for the move
+	const FVector UnrotatedAcceleration =
+		UKismetMathLibrary::Quat_UnrotateVector(UpdatedComponent->GetComponentQuat(), Acceleration);
 
 	const float DotResult =
-		FVector::DotProduct(UnrotatedLastInputVector.GetSafeNormal(), FVector::UpVector);
+		FVector::DotProduct(UnrotatedAcceleration.GetSafeNormal(), FVector::UpVector);
 
 	if (DotResult >= 0.9f)
 	{
@@ -612,8 +2110,19 @@ void UCustomMovementComponent::HandleHopUp()
 
 bool UCustomMovementComponent::CheckCanHopUp(FVector& OutHopUpTargetPosition)
 {
-	FHitResult HopUpHit = TraceFromEyeHeight(100.f, -20.f);
-	FHitResult SafetyLedgeHit = TraceFromEyeHeight(100.f, 150.f);
+	SCOPE_CYCLE_COUNTER(STAT_CheckCanHopUp);
+
+	if (const FClimbHopCell* HopCell = FindClimbHopCell())
+	{
+		OutHopUpTargetPosition = CurrentClimbableSurfaceLocation + FVector(HopCell->HopUpOffset);
+
+		return HopCell->bCanHopUp;
+	}
+
+	ResolveEnvironmentProbes(EClimbProbe::EyeHopUp | EClimbProbe::EyeSafetyLedge);
+
+	const FHitResult& HopUpHit = EnvironmentSnapshot.EyeHopUpHit;
+	const FHitResult& SafetyLedgeHit = EnvironmentSnapshot.EyeSafetyLedgeHit;
 
 	if (HopUpHit.bBlockingHit && SafetyLedgeHit.bBlockingHit)
 	{
@@ -639,7 +2148,18 @@ void UCustomMovementComponent::HandleHopDown()
 
 bool UCustomMovementComponent::CheckCanHopDown(FVector& OutHopDownTargetPosition)
 {
-	FHitResult HopDownHit = TraceFromEyeHeight(100.f, -300.f);
+	SCOPE_CYCLE_COUNTER(STAT_CheckCanHopDown);
+
+	if (const FClimbHopCell* HopCell = FindClimbHopCell())
+	{
+		OutHopDownTargetPosition = CurrentClimbableSurfaceLocation + FVector(HopCell->HopDownOffset);
+
+		return HopCell->bCanHopDown;
+	}
+
+	ResolveEnvironmentProbes(EClimbProbe::EyeHopDown);
+
+	const FHitResult& HopDownHit = EnvironmentSnapshot.EyeHopDownHit;
 
 	if (HopDownHit.bBlockingHit)
 	{
@@ -651,12 +2171,56 @@ bool UCustomMovementComponent::CheckCanHopDown(FVector& OutHopDownTargetPosition
 	return false;
 }
 
+const FClimbHopCell* UCustomMovementComponent::FindClimbHopCell() const
+{
+	if (!bUseBakedClimbIndex || !ClimbIndexSubsystem || !IsClimbing()) return nullptr;
+
+	// The table only knows what can't move, anything movable within reach of the eye probes needs them traced live
+	static constexpr float EyeProbeReach = 300.f; // Furthest probe offset from eye height, the hop down
+	const FBox ProbeBounds = FBox::BuildAABB(UpdatedComponent->GetComponentLocation(), FVector(CharacterOwner->BaseEyeHeight + EyeProbeReach));
+
+	if (ClimbIndexSubsystem->OverlapsMovableClimbable(ProbeBounds)) return nullptr;
+
+	return ClimbIndexSubsystem->FindHopCell(CurrentClimbableSurfaceLocation, CurrentClimbableSurfaceNormal,
+		CharacterOwner->BaseEyeHeight, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius());
+}
+
+bool UCustomMovementComponent::GetClimbHopHints(bool& bOutCanHopUp, bool& bOutCanHopDown, bool& bOutCanMantle) const
+{
+	bOutCanHopUp = false;
+	bOutCanHopDown = false;
+	bOutCanMantle = false;
+
+	const FClimbHopCell* HopCell = FindClimbHopCell();
+	if (!HopCell) return false;
+
+	bOutCanHopUp = HopCell->bCanHopUp;
+	bOutCanHopDown = HopCell->bCanHopDown;
+	bOutCanMantle = HopCell->bCanMantle;
+
+	return true;
+}
 
 FVector UCustomMovementComponent::GetUnrotatedClimbVelocity() const
 {
 	return UKismetMathLibrary::Quat_UnrotateVector(UpdatedComponent->GetComponentQuat(), Velocity);
 }
 
+void UCustomMovementComponent::PublishMovementSnapshot()
+{
+	if (!UpdatedComponent) return;
+
+	// Built whole and assigned once, the anim instance copies it on the game thread before its worker thread update
+	FCharacterMovementSnapshot Snapshot;
+	Snapshot.Velocity = Velocity;
+	Snapshot.UnrotatedClimbVelocity = GetUnrotatedClimbVelocity();
+	Snapshot.bHasAcceleration = !Acceleration.IsZero();
+	Snapshot.bIsFalling = IsFalling();
+	Snapshot.bIsClimbing = IsClimbing();
+
+	MovementSnapshot = Snapshot;
+}
+
 #pragma endregion
 
 // Wall Running doesn't work properly, the character doesn't stick to the wall and gravity is messed up - Wall Running is disabled for now
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Components/GrappleRopeComponent.h"
+#include "Components/CustomMovementComponent.h"
+#include "GameFramework/Character.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInterface.h"
+#include "UObject/ConstructorHelpers.h"
+
+namespace GrappleRope
+{
+	// Engine cylinder, 100 units long along Z with a 50 unit radius
+	static const TCHAR* CylinderMeshPath = TEXT("/Engine/BasicShapes/Cylinder.Cylinder");
+	static constexpr float CylinderRadius = 50.f;
+}
+
+UGrappleRopeComponent::UGrappleRopeComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics; // After the movement, so the rope starts where the character ended up
+
+	// World space at the anchor, the parent's transform updates skip fully absolute children
+	SetUsingAbsoluteLocation(true);
+	SetUsingAbsoluteRotation(true);
+	SetUsingAbsoluteScale(true);
+
+	SetMobility(EComponentMobility::Movable);
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetGenerateOverlapEvents(false);
+	SetCanEverAffectNavigation(false);
+	CastShadow = false;
+
+	SetVisibility(false);
+
+	static ConstructorHelpers::FObjectFinder<UMaterialInterface> GrappleMaterial(TEXT("/Game/System/GrappleMaterial"));
+	RopeMaterial = GrappleMaterial.Object;
+}
+
+void UGrappleRopeComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!GetStaticMesh())
+	{
+		SetStaticMesh(LoadObject<UStaticMesh>(nullptr, GrappleRope::CylinderMeshPath));
+	}
+
+	if (RopeMaterial)
+	{
+		SetMaterial(0, RopeMaterial);
+	}
+
+	SetForwardAxis(ESplineMeshAxis::Z, false);
+
+	const float CrossSectionScale = RopeRadius / GrappleRope::CylinderRadius;
+	SetStartScale(FVector2D(CrossSectionScale), false);
+	SetEndScale(FVector2D(CrossSectionScale), false);
+}
+
+void UGrappleRopeComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	UpdateRope();
+}
+
+void UGrappleRopeComponent::SetRopeActive(bool bActive)
+{
+	SetComponentTickEnabled(bActive);
+	SetVisibility(bActive);
+
+	if (bActive)
+	{
+		UpdateRope();
+	}
+}
+
+// One Hermite segment from the rope start to the anchor. A taut rope is straight, a slack one dips in the middle by the
+// sag of a parabola of the same length
+void UGrappleRopeComponent::UpdateRope()
+{
+	const ACharacter* Character = Cast<ACharacter>(GetOwner());
+	const UCustomMovementComponent* MovementComponent = Character ? Cast<UCustomMovementComponent>(Character->GetCharacterMovement()) : nullptr;
+	if (!MovementComponent) return;
+
+	const FVector Anchor = MovementComponent->GetGrappleAnchor();
+
+	if (!GetComponentLocation().Equals(Anchor))
+	{
+		SetWorldLocationAndRotation(Anchor, FQuat::Identity);
+	}
+
+	// Identity rotation and scale, so local space is world space offset to the anchor
+	const FVector Start = (RopeStart ? RopeStart->GetComponentLocation() : Character->GetActorLocation()) - Anchor;
+	const FVector Chord = -Start;
+	const float ChordLength = Chord.Size();
+
+	const float Slack = FMath::Max(MovementComponent->GetGrappleRopeLength() - ChordLength, 0.f);
+	const float Sag = ChordLength > UE_KINDA_SMALL_NUMBER ? FMath::Min(FMath::Sqrt(3.f * ChordLength * Slack / 8.f), MaxRopeSag) : 0.f;
+
+	// Opposite offsets on the two tangents move the curve's midpoint by a quarter of the offset
+	const FVector SagOffset = FVector(0.f, 0.f, -4.f * Sag);
+
+	SetStartAndEnd(Start, Chord + SagOffset, FVector::ZeroVector, Chord - SagOffset, true);
+}
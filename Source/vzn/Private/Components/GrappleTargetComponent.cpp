@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Components/GrappleTargetComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "GrappleTargetSubsystem.h"
+#include "Engine/World.h"
+
+UGrappleTargetComponent::UGrappleTargetComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UGrappleTargetComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UGrappleTargetSubsystem* TargetSubsystem = GetWorld()->GetSubsystem<UGrappleTargetSubsystem>())
+	{
+		TargetSubsystem->RegisterTarget(this);
+	}
+}
+
+void UGrappleTargetComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGrappleTargetSubsystem* TargetSubsystem = GetWorld()->GetSubsystem<UGrappleTargetSubsystem>())
+	{
+		TargetSubsystem->UnregisterTarget(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UGrappleTargetComponent::OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
+
+	if (!bRegistered) return;
+
+	if (UGrappleTargetSubsystem* TargetSubsystem = GetWorld()->GetSubsystem<UGrappleTargetSubsystem>())
+	{
+		TargetSubsystem->UpdateTarget(this);
+	}
+}
+
+void UGrappleTargetComponent::SetHighlighted(bool bInHighlighted)
+{
+	if (bHighlighted == bInHighlighted) return;
+
+	bHighlighted = bInHighlighted;
+
+	AActor* Owner = GetOwner();
+	if (!Owner) return;
+
+	TInlineComponentArray<UPrimitiveComponent*> Primitives(Owner);
+	for (UPrimitiveComponent* Primitive : Primitives)
+	{
+		Primitive->SetRenderCustomDepth(bHighlighted);
+	}
+}
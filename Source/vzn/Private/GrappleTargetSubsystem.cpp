@@ -0,0 +1,216 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GrappleTargetSubsystem.h"
+#include "Components/ClimbStats.h"
+#include "Engine/World.h"
+#include "DrawDebugHelpers.h"
+
+DECLARE_CYCLE_STAT(TEXT("Grapple Target Query"), STAT_GrappleTargetQuery, STATGROUP_Climb);
+
+static TAutoConsoleVariable<int32> CVarGrappleDrawDebug(
+	TEXT("grapple.DrawDebug"),
+	0,
+	TEXT("Draw the aim ray and the ray to the chosen grapple target."));
+
+void UGrappleTargetSubsystem::RegisterTarget(UGrappleTargetComponent* InTarget)
+{
+	if (!InTarget || InTarget->bRegistered) return;
+
+	InTarget->bRegistered = true;
+	InTarget->RegisteredCell = GetCell(InTarget->GetComponentLocation());
+	AddToCell(InTarget, InTarget->RegisteredCell);
+
+	NumTargets++;
+}
+
+void UGrappleTargetSubsystem::UnregisterTarget(UGrappleTargetComponent* InTarget)
+{
+	if (!InTarget || !InTarget->bRegistered) return;
+
+	RemoveFromCell(InTarget, InTarget->RegisteredCell);
+	InTarget->bRegistered = false;
+
+	NumTargets--;
+}
+
+void UGrappleTargetSubsystem::UpdateTarget(UGrappleTargetComponent* InTarget)
+{
+	if (!InTarget || !InTarget->bRegistered) return;
+
+	// Locations are read at query time, only crossing into another cell needs any work
+	const FIntVector NewCell = GetCell(InTarget->GetComponentLocation());
+	if (NewCell == InTarget->RegisteredCell) return;
+
+	RemoveFromCell(InTarget, InTarget->RegisteredCell);
+	AddToCell(InTarget, NewCell);
+	InTarget->RegisteredCell = NewCell;
+}
+
+UGrappleTargetComponent* UGrappleTargetSubsystem::FindTarget(const FGrappleTargetQuery& InQuery) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GrappleTargetQuery);
+
+	if (Cells.IsEmpty()) return nullptr;
+
+	const float ConeHalfAngleRad = FMath::DegreesToRadians(FMath::Clamp(InQuery.ConeHalfAngle, 0.f, 89.f));
+	const float MinAimDot = FMath::Cos(ConeHalfAngleRad);
+	const float MaxDistanceSquared = FMath::Square(InQuery.MaxDistance);
+
+	// Scored candidates, the best one that the origin can see wins
+	TArray<TPair<float, UGrappleTargetComponent*>, TInlineAllocator<16>> Candidates;
+
+	auto ConsiderCell = [&](const TArray<UGrappleTargetComponent*>& InCellTargets)
+	{
+		for (UGrappleTargetComponent* Target : InCellTargets)
+		{
+			if (!(InQuery.TypeMask & (1 << Target->GetTargetType()))) continue;
+			if (InQuery.IgnoreActor && Target->GetOwner() == InQuery.IgnoreActor) continue;
+
+			const FVector ToTarget = Target->GetComponentLocation() - InQuery.Origin;
+			const float DistanceSquared = ToTarget.SizeSquared();
+			if (DistanceSquared > MaxDistanceSquared || DistanceSquared < UE_KINDA_SMALL_NUMBER) continue;
+
+			const float Distance = FMath::Sqrt(DistanceSquared);
+			const float AimDot = FVector::DotProduct(ToTarget / Distance, InQuery.Direction);
+			if (AimDot < MinAimDot) continue;
+
+			// Closest to the crosshair wins, distance only breaks near ties
+			Candidates.Emplace(AimDot - 0.01f * Distance / InQuery.MaxDistance, Target);
+		}
+	};
+
+	// Every point of the cone within reach is within MaxDistance * sin(angle) of its axis
+	const FVector AxisEnd = InQuery.Origin + InQuery.Direction * InQuery.MaxDistance;
+	const FBox ConeBounds = FBox(InQuery.Origin.ComponentMin(AxisEnd), InQuery.Origin.ComponentMax(AxisEnd)).ExpandBy(InQuery.MaxDistance * FMath::Sin(ConeHalfAngleRad));
+
+	const FIntVector MinCell = GetCell(ConeBounds.Min);
+	const FIntVector MaxCell = GetCell(ConeBounds.Max);
+	const int64 NumCoveredCells = int64(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1) * (MaxCell.Z - MinCell.Z + 1);
+
+	if (NumCoveredCells > Cells.Num())
+	{
+		// Fewer occupied cells than the cone covers, walking them all is cheaper than the lookups
+		for (const TPair<FIntVector, TArray<UGrappleTargetComponent*>>& Cell : Cells)
+		{
+			ConsiderCell(Cell.Value);
+		}
+	}
+	else
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+			{
+				for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+				{
+					if (const TArray<UGrappleTargetComponent*>* CellTargets = Cells.Find(FIntVector(X, Y, Z)))
+					{
+						ConsiderCell(*CellTargets);
+					}
+				}
+			}
+		}
+	}
+
+	Candidates.Sort([](const TPair<float, UGrappleTargetComponent*>& A, const TPair<float, UGrappleTargetComponent*>& B) { return A.Key > B.Key; });
+
+	// A blocked target falls through to the next one, capped so a cone full of hidden targets stays a few rays
+	UGrappleTargetComponent* BestTarget = nullptr;
+	const int32 NumChecks = FMath::Min(Candidates.Num(), MaxVisibilityChecks);
+
+	for (int32 Index = 0; Index < NumChecks; Index++)
+	{
+		if (IsTargetVisible(InQuery, Candidates[Index].Value))
+		{
+			BestTarget = Candidates[Index].Value;
+			break;
+		}
+	}
+
+#if ENABLE_DRAW_DEBUG
+	if (CVarGrappleDrawDebug.GetValueOnGameThread())
+	{
+		DrawDebugLine(GetWorld(), InQuery.Origin, AxisEnd, FColor::Cyan);
+
+		if (BestTarget)
+		{
+			DrawDebugLine(GetWorld(), InQuery.Origin, BestTarget->GetComponentLocation(), FColor::Green);
+		}
+	}
+#endif
+
+	return BestTarget;
+}
+
+UGrappleTargetComponent* UGrappleTargetSubsystem::FindTargetNear(const FVector& InLocation, float InRadius, uint8 InTypeMask) const
+{
+	const FIntVector MinCell = GetCell(InLocation - FVector(InRadius));
+	const FIntVector MaxCell = GetCell(InLocation + FVector(InRadius));
+	const float RadiusSquared = FMath::Square(InRadius);
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+			{
+				const TArray<UGrappleTargetComponent*>* CellTargets = Cells.Find(FIntVector(X, Y, Z));
+				if (!CellTargets) continue;
+
+				for (UGrappleTargetComponent* Target : *CellTargets)
+				{
+					if (!(InTypeMask & (1 << Target->GetTargetType()))) continue;
+
+					if (FVector::DistSquared(Target->GetComponentLocation(), InLocation) <= RadiusSquared)
+					{
+						return Target;
+					}
+				}
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+FIntVector UGrappleTargetSubsystem::GetCell(const FVector& InLocation) const
+{
+	return FIntVector(
+		FMath::FloorToInt(InLocation.X / CellSize),
+		FMath::FloorToInt(InLocation.Y / CellSize),
+		FMath::FloorToInt(InLocation.Z / CellSize));
+}
+
+void UGrappleTargetSubsystem::AddToCell(UGrappleTargetComponent* InTarget, const FIntVector& InCell)
+{
+	Cells.FindOrAdd(InCell).Add(InTarget);
+}
+
+void UGrappleTargetSubsystem::RemoveFromCell(UGrappleTargetComponent* InTarget, const FIntVector& InCell)
+{
+	TArray<UGrappleTargetComponent*>* CellTargets = Cells.Find(InCell);
+	if (!CellTargets) return;
+
+	CellTargets->RemoveSwap(InTarget);
+
+	// Empty cells are dropped, so walking the whole map stays proportional to the targets
+	if (CellTargets->IsEmpty())
+	{
+		Cells.Remove(InCell);
+	}
+}
+
+bool UGrappleTargetSubsystem::IsTargetVisible(const FGrappleTargetQuery& InQuery, const UGrappleTargetComponent* InTarget) const
+{
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(GrappleTargetVisibility), false, InQuery.IgnoreActor);
+
+	FHitResult Hit;
+	if (!GetWorld()->LineTraceSingleByChannel(Hit, InQuery.Origin, InTarget->GetComponentLocation(), ECC_Visibility, Params))
+	{
+		return true;
+	}
+
+	// The target's own geometry usually stops the ray just short of the point
+	return Hit.GetActor() == InTarget->GetOwner();
+}
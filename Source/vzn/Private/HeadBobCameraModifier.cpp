@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HeadBobCameraModifier.h"
+#include "Camera/CameraComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "vzn/vznCharacter.h"
+
+bool UHeadBobCameraModifier::ModifyCamera(float DeltaTime, FMinimalViewInfo& InOutPOV)
+{
+	Super::ModifyCamera(DeltaTime, InOutPOV);
+
+	// Only the first person camera bobs
+	const AvznCharacter* Character = CameraOwner ? Cast<AvznCharacter>(CameraOwner->GetViewTarget()) : nullptr;
+	if (!Character || !Character->GetFirstPersonCamera() || !Character->GetFirstPersonCamera()->IsActive())
+	{
+		BobOffset = 0.f;
+		return false;
+	}
+
+	// No bobbing effect when standing still
+	float TargetOffset = 0.f;
+
+	if (Character->GetVelocity().SizeSquared() > 0 && Character->GetCharacterMovement()->IsMovingOnGround())
+	{
+		// Calculate target offset with bobbing using a sine wave
+		TargetOffset = FMath::Sin(GetWorld()->GetTimeSeconds() * BobbingSpeed) * BobbingAmount;
+	}
+	else if (FMath::IsNearlyZero(BobOffset, 0.01f))
+	{
+		BobOffset = 0.f;
+		return false;
+	}
+
+	// Camera smoothly transitions from standing still to movement using lerp
+	BobOffset = FMath::Lerp(BobOffset, TargetOffset, FMath::Min(DeltaTime * BobbingSpeed, 1.f));
+
+	InOutPOV.Location += Character->GetActorUpVector() * BobOffset;
+
+	return false;
+}
@@ -4,6 +4,7 @@
 #include "Switch.h"
 #include "Components/BoxComponent.h"
 #include "MovingPlatform.h"
+#include "Components/GrappleTargetComponent.h"
 
 // Sets default values
 ASwitch::ASwitch()
@@ -16,6 +17,10 @@ ASwitch::ASwitch()
 
 	SwitchMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Switch Mesh"));
 	SwitchMesh->SetupAttachment(RootComponent);
+
+	InteractTarget = CreateDefaultSubobject<UGrappleTargetComponent>(TEXT("Interact Target"));
+	InteractTarget->SetupAttachment(RootComponent);
+	InteractTarget->SetTargetType(EGrappleTargetType::Interactable);
 }
 
 // Called when the game starts or when spawned
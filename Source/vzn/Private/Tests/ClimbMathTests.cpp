@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "Components/ClimbMath.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ClimbMathTests
+{
+	// Same 60 degrees CheckShouldStopClimbing and CheckHasReachedLedge use
+	static const float MaxClimbableSurfaceCos = FMath::Cos(FMath::DegreesToRadians(60.f));
+
+	// Grid of hits on the wall X = InWallX facing the character at the origin, like a capsule trace against a flat wall
+	static void AddWallSamples(FClimbSurfaceSamples& OutSamples, double InWallX, const FVector& InNormal)
+	{
+		for (int32 Y = -1; Y <= 1; Y++)
+		{
+			for (int32 Z = -1; Z <= 1; Z++)
+			{
+				OutSamples.Add(FVector(InWallX, Y * 20.0, Z * 40.0), InNormal, 0);
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FClimbMathFitPlaneTest, "vzn.Climb.Math.FitPlane", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FClimbMathFitPlaneTest::RunTest(const FString& Parameters)
+{
+	const FClimbPlaneFitSettings Settings;
+	const FVector WallNormal(-1.0, 0.0, 0.0);
+
+	FVector Location;
+	FVector Normal;
+
+	FClimbSurfaceSamples Samples;
+	Samples.Reset(FVector::ZeroVector);
+
+	TestFalse(TEXT("No samples, no plane"), Samples.FitPlane(FVector::ZeroVector, Settings, Location, Normal));
+
+	ClimbMathTests::AddWallSamples(Samples, 50.0, WallNormal);
+
+	TestTrue(TEXT("Flat wall fits"), Samples.FitPlane(FVector::ZeroVector, Settings, Location, Normal));
+	TestTrue(TEXT("Flat wall normal"), Normal.Equals(WallNormal, 1e-3));
+	TestEqual(TEXT("Flat wall location is on the wall"), Location.X, 50.0, 0.1);
+
+	// A hit on a crate in front of the wall, off the plane and facing up, is rejected and doesn't tilt the wall
+	Samples.Add(FVector(30.0, 0.0, -20.0), FVector::UpVector, 1);
+
+	TestTrue(TEXT("Wall with an outlier fits"), Samples.FitPlane(FVector::ZeroVector, Settings, Location, Normal));
+	TestTrue(TEXT("Outlier rejected from the normal"), Normal.Equals(WallNormal, 1e-2));
+	TestEqual(TEXT("Outlier rejected from the location"), Location.X, 50.0, 0.5);
+
+	// A single hit doesn't span a plane, the fit falls back to the hit's own normal
+	FClimbSurfaceSamples SingleSample;
+	SingleSample.Reset(FVector::ZeroVector);
+	SingleSample.Add(FVector(50.0, 0.0, 0.0), WallNormal, 0);
+
+	TestTrue(TEXT("Single sample fits"), SingleSample.FitPlane(FVector::ZeroVector, Settings, Location, Normal));
+	TestTrue(TEXT("Single sample keeps its normal"), Normal.Equals(WallNormal, 1e-3));
+
+	// The averaging path has no normal when the hits face opposite ways, so the caller keeps the previous surface
+	FClimbSurfaceSamples Opposing;
+	Opposing.Reset(FVector::ZeroVector);
+	Opposing.Add(FVector(50.0, 0.0, 0.0), WallNormal, 0);
+	Opposing.Add(FVector(-50.0, 0.0, 0.0), -WallNormal, 1);
+
+	TestFalse(TEXT("Cancelling normals don't resolve"), ClimbMath::ResolveSurface(Opposing, false, FVector::ZeroVector, Settings, Location, Normal));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FClimbMathStopAndLedgeTest, "vzn.Climb.Math.StopAndLedge", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FClimbMathStopAndLedgeTest::RunTest(const FString& Parameters)
+{
+	const float MaxCos = ClimbMathTests::MaxClimbableSurfaceCos;
+
+	auto NormalAtAngleFromUp = [](float InDegrees)
+	{
+		return FVector(FMath::Sin(FMath::DegreesToRadians(InDegrees)), 0.f, FMath::Cos(FMath::DegreesToRadians(InDegrees)));
+	};
+
+	// Stop check: climbing stops once the surface is flat enough to stand on
+	TestFalse(TEXT("Vertical wall keeps climbing"), ClimbMath::IsWalkableNormal(FVector(-1.0, 0.0, 0.0), FVector::UpVector, MaxCos));
+	TestFalse(TEXT("Overhang keeps climbing"), ClimbMath::IsWalkableNormal(NormalAtAngleFromUp(120.f), FVector::UpVector, MaxCos));
+	TestFalse(TEXT("61 degrees keeps climbing"), ClimbMath::IsWalkableNormal(NormalAtAngleFromUp(61.f), FVector::UpVector, MaxCos));
+	TestTrue(TEXT("59 degrees stops climbing"), ClimbMath::IsWalkableNormal(NormalAtAngleFromUp(59.f), FVector::UpVector, MaxCos));
+
+	// Ledge check: the surface found above the wall has to be walkable to mantle onto
+	TestTrue(TEXT("Flat top is a ledge"), ClimbMath::IsWalkableNormal(FVector::UpVector, FVector::UpVector, MaxCos));
+	TestFalse(TEXT("Steep top isn't a ledge"), ClimbMath::IsWalkableNormal(NormalAtAngleFromUp(70.f), FVector::UpVector, MaxCos));
+
+	// Floor check: any floor sample facing along the up axis ends the climb when moving down
+	FClimbSurfaceSamples FloorSamples;
+	FloorSamples.Reset(FVector::ZeroVector);
+	ClimbMathTests::AddWallSamples(FloorSamples, 50.0, FVector(-1.0, 0.0, 0.0));
+
+	TestFalse(TEXT("Wall only isn't a floor"), FloorSamples.AnyNormalParallelTo(FVector::UpVector));
+
+	FloorSamples.Add(FVector(0.0, 0.0, -90.0), FVector::UpVector, 1);
+
+	TestTrue(TEXT("Floor sample past the vector batch is found"), FloorSamples.AnyNormalParallelTo(FVector::UpVector));
+	TestTrue(TEXT("Either direction counts"), FloorSamples.AnyNormalParallelTo(-FVector::UpVector));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FClimbMathSnapTest, "vzn.Climb.Math.Snap", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FClimbMathSnapTest::RunTest(const FString& Parameters)
+{
+	const FVector WallNormal(-1.0, 0.0, 0.0);
+	const FVector Forward(1.0, 0.0, 0.0);
+
+	// 40 units from the wall, pulled in by distance * dt * speed along the normal
+	const FVector Snap = ClimbMath::GetSnapDelta(FVector(40.0, 0.0, 0.0), WallNormal, FVector::ZeroVector, Forward, 0.1f, 5.f);
+	TestTrue(TEXT("Snap pulls towards the wall"), Snap.Equals(FVector(20.0, 0.0, 0.0), 1e-3));
+
+	// Only the distance in front counts, sideways and vertical offsets to the surface point don't pull harder
+	const FVector OffsetSnap = ClimbMath::GetSnapDelta(FVector(40.0, 30.0, -50.0), WallNormal, FVector::ZeroVector, Forward, 0.1f, 5.f);
+	TestTrue(TEXT("Offsets along the wall don't change the snap"), OffsetSnap.Equals(Snap, 1e-3));
+
+	// Against the wall already, nothing left to snap
+	const FVector NoSnap = ClimbMath::GetSnapDelta(FVector::ZeroVector, WallNormal, FVector::ZeroVector, Forward, 0.1f, 5.f);
+	TestTrue(TEXT("No snap on the surface"), NoSnap.IsNearlyZero());
+
+	// The climb rotation faces into the wall
+	const FQuat TargetQuat = ClimbMath::GetClimbTargetQuat(WallNormal);
+	TestTrue(TEXT("Climb rotation faces the wall"), TargetQuat.GetForwardVector().Equals(Forward, 1e-3));
+	TestTrue(TEXT("Climb rotation stays upright on a vertical wall"), TargetQuat.GetUpVector().Equals(FVector::UpVector, 1e-3));
+
+	return true;
+}
+
+#endif
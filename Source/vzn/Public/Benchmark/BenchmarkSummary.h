@@ -0,0 +1,18 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+
+// Shared by the benchmark and load test result writers
+namespace BenchmarkSummary
+{
+	VZN_API double Percentile(TArray<double> InValues, double InPercentile);
+
+	// avg, p50, p95 and max of the values
+	VZN_API TSharedRef<FJsonObject> MakeSummary(const TArray<double>& InValues);
+
+	// Writes Saved/Benchmarks/<BaseName>_<timestamp>.csv and .json, false if either failed
+	VZN_API bool WriteResults(const FString& InBaseName, const FString& InCsv, const TSharedRef<FJsonObject>& InJson, FString& OutCsvPath, FString& OutJsonPath);
+}
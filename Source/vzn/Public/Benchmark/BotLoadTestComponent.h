@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "BotLoadTestComponent.generated.h"
+
+/**
+ * Added to each bot's character by a server running the bot load test and replicated to its client, so the reset RPC
+ * only exists on characters taking part in the test rather than on every player character.
+ */
+UCLASS(NotBlueprintable)
+class VZN_API UBotLoadTestComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UBotLoadTestComponent();
+
+	UFUNCTION(Server, Reliable)
+	void ServerResetBot(); // Back to the start of the bot's lane
+};
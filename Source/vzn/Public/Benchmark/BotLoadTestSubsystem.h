@@ -0,0 +1,150 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Benchmark/ClimbMovementScript.h"
+#include "Benchmark/ClimbCourse.h"
+#include "BotLoadTestSubsystem.generated.h"
+
+class AvznCharacter;
+class APlayerController;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogBotLoadTest, Log, All);
+
+// One sample interval on the server
+struct FBotLoadServerSample
+{
+	double Time = 0.0;
+	int32 NumConnections = 0;
+	double FrameMsAvg = 0.0;
+	double FrameMsMax = 0.0;
+	double WorldTickMsAvg = 0.0;
+	double WorldTickMsMax = 0.0;
+	int32 InBytesPerSecond = 0; // Whole net driver
+	int32 OutBytesPerSecond = 0;
+	uint32 Corrections = 0;
+};
+
+// One connection over one sample interval
+struct FBotLoadConnectionSample
+{
+	int32 SampleIndex = 0; // Server sample taken at the same time
+	int32 Lane = INDEX_NONE; // Stands in for the connection, stable for the whole run
+	int32 InBytesPerSecond = 0;
+	int32 OutBytesPerSecond = 0;
+	float PingMs = 0.f;
+	uint32 Corrections = 0;
+	uint32 Resets = 0;
+};
+
+/**
+ * Network load test for sizing servers. A server started with -BotLoadTest builds the course, puts each joining player
+ * at the start of their own lane and samples tick time, bandwidth and corrections per connection, then writes the
+ * results to Saved/Benchmarks. A client started with -BotClient builds the same course and drives its character through
+ * the bot script instead of reading input, so every move goes through the normal prediction path.
+ *
+ * -BotLanes=16			Lanes built on every machine, at least the number of bot clients
+ * -BotLoadSeconds=120	Seconds the server samples for after the warmup, then it writes results and exits
+ * -BotLoadWarmup=10	Seconds after the first bot joins before sampling, for the other bots to connect
+ */
+UCLASS()
+class VZN_API UBotLoadTestSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void ResetBot(AvznCharacter* InCharacter); // Server only, back to the start of the bot's lane
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	void ParseCommandLine();
+
+	void TickServer(float DeltaTime);
+	void TickClient(float DeltaTime);
+
+	void AssignLanes();
+
+	void ResetCorrectionBaselines();
+	void RecordFrame(float DeltaTime);
+	void OnWorldTickStart(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds);
+	void TakeSample();
+	void WriteResults() const;
+
+#pragma region Settings
+
+	int32 NumLanes = 16;
+
+	float LoadSeconds = 120.f;
+
+	float WarmupSeconds = 10.f;
+
+	float SampleInterval = 1.f; // Matches the period the net connections update their byte rates over
+
+	float ClientStartDelay = 1.f; // Time for the server's reset to reach the client before the script starts
+
+#pragma endregion
+
+	FClimbCourse Course;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AActor>> CourseActors;
+
+	bool bServer = false;
+	bool bClient = false;
+	bool bFinished = false;
+
+#pragma region Server
+
+	struct FBotLane
+	{
+		TWeakObjectPtr<APlayerController> Controller;
+		int32 Lane = INDEX_NONE;
+		uint32 LastCorrections = 0;
+		uint32 Resets = 0;
+		uint32 LastResets = 0;
+	};
+
+	TArray<FBotLane> BotLanes;
+
+	double RunTime = 0.0; // From the first bot joining, sampling starts after the warmup
+
+	int32 IntervalFrames = 0;
+	double IntervalFrameMs = 0.0;
+	double IntervalFrameMsMax = 0.0;
+	double IntervalWorldTickMs = 0.0;
+	double IntervalWorldTickMsMax = 0.0;
+
+	uint64 WorldTickStartCycles = 0;
+	FDelegateHandle WorldTickStartHandle;
+
+	TArray<FBotLoadServerSample> ServerSamples;
+	TArray<FBotLoadConnectionSample> ConnectionSamples;
+
+#pragma endregion
+
+#pragma region Client
+
+	TWeakObjectPtr<AvznCharacter> LocalBot;
+
+	FClimbMovementScript Script;
+
+	FClimbMovementScriptPlayer ScriptPlayer;
+
+	float ClientStartTime = 0.f; // Counts down before the script starts
+
+#pragma endregion
+};
@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Benchmark/ClimbMovementScript.h"
+#include "Benchmark/ClimbCourse.h"
+#include "ClimbBenchmarkSubsystem.generated.h"
+
+class AvznCharacter;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogClimbBenchmark, Log, All);
+
+struct FClimbBenchmarkFrame
+{
+	int32 NumCharacters = 0;
+	int32 NumClimbing = 0;
+	double FrameMs = 0.0;
+	double WorldTickMs = 0.0; // From the start of the world tick until every character has moved
+	double PhysClimbMs = 0.0;
+	uint32 SceneQueries = 0;
+	uint32 ComponentMoves = 0;
+	uint32 TraceHeapAllocations = 0; // Climb hit buffers that had to grow this frame
+};
+
+/**
+ * Headless stress run for the climb movement, only created with -ClimbBenchmark on the command line.
+ * Builds a course lane per character away from the loaded map, runs N scripted characters through it
+ * for each requested count and writes per frame results and a summary to Saved/Benchmarks.
+ *
+ * -ClimbBenchmarkCounts=1,16,64,256	Character counts to run, in order
+ * -ClimbBenchmarkFrames=600			Measured frames per count, after the warmup
+ * -ClimbBenchmarkCharacter=<class>		Character class to spawn, defaults to the third person blueprint
+ */
+UCLASS()
+class VZN_API UClimbBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	void ParseCommandLine();
+
+	void StartRun(int32 InCountIndex);
+	void EndRun();
+	void SpawnCharacters(int32 InNumCharacters);
+	void DestroyCharacters();
+
+	void RecordFrame(float DeltaTime);
+
+	uint64 SumTraceHeapAllocations() const;
+
+	void OnWorldTickStart(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds);
+	void WriteResults() const;
+
+	FTransform GetLaneStartTransform(int32 InLane) const;
+
+#pragma region Settings
+
+	TArray<int32> CharacterCounts = { 1, 16, 64, 256 };
+
+	int32 WarmupFrames = 120; // Lets characters settle on the floor and streaming finish before measuring
+
+	int32 MeasuredFrames = 600;
+
+	FString CharacterClassPath = TEXT("/Game/ThirdPerson/Blueprints/BP_ThirdPersonCharacter.BP_ThirdPersonCharacter_C");
+
+	FClimbCourse Course;
+
+	float ScriptStagger = 0.37f; // Seconds between characters' script positions
+
+#pragma endregion
+
+	UPROPERTY(Transient)
+	TSubclassOf<AvznCharacter> CharacterClass;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AActor>> CourseActors;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AvznCharacter>> Characters;
+
+	TArray<FClimbMovementScriptPlayer> ScriptPlayers;
+
+	FClimbMovementScript Script;
+
+	// All frames of every run, in run order
+	TArray<FClimbBenchmarkFrame> Frames;
+
+	int32 CountIndex = INDEX_NONE;
+	int32 RunFrame = 0;
+	uint64 LastTraceHeapAllocations = 0;
+	uint64 WorldTickStartCycles = 0;
+	FDelegateHandle WorldTickStartHandle;
+	bool bFinished = false;
+};
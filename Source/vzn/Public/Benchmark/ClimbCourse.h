@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectPtr.h"
+
+class AActor;
+class UWorld;
+
+/**
+ * Course lanes for the climb benchmark and the bot load test. Nothing is replicated, every machine that needs the course
+ * builds it locally from the same settings so servers and clients collide against the same geometry.
+ */
+struct VZN_API FClimbCourse
+{
+	FVector Origin = FVector(0.f, 0.f, 20000.f); // Far above the loaded map so lanes don't touch level geometry
+
+	float LaneSpacing = 400.f;
+
+	bool bWithProps = false; // Launch pad, switch and moving platform run-up in front of each lane
+
+	FString LaunchPadClassPath = TEXT("/Game/System/Actors/BP_LaunchPad.BP_LaunchPad_C");
+	FString SwitchClassPath = TEXT("/Game/System/Actors/BP_Switch.BP_Switch_C");
+	FString MovingPlatformClassPath = TEXT("/Game/System/Actors/BP_MovingPlatform.BP_MovingPlatform_C");
+
+	void Build(UWorld* InWorld, int32 InNumLanes, TArray<TObjectPtr<AActor>>& OutActors) const;
+
+	FTransform GetLaneStartTransform(int32 InLane, float InCapsuleHalfHeight) const;
+
+private:
+
+	void BuildProps(UWorld* InWorld, const FVector& InLaneOrigin, TArray<TObjectPtr<AActor>>& OutActors) const;
+
+	AActor* SpawnBlock(UWorld* InWorld, const FVector& InCenter, const FVector& InSize) const;
+
+	template<typename ActorType>
+	ActorType* SpawnProp(UWorld* InWorld, const FString& InClassPath, const FVector& InLocation, TFunctionRef<void(ActorType*)> InSetup) const;
+};
@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ClimbMathBenchmarkCommandlet.generated.h"
+
+/**
+ * Microbenchmarks for the ClimbMath kernels on synthetic surface samples, no world is loaded.
+ * UnrealEditor-Cmd vzn.uproject -run=ClimbMathBenchmark [-Iterations=200000] [-Samples=8] [-Seed=1234] [-Csv=<path>]
+ */
+UCLASS()
+class VZN_API UClimbMathBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UClimbMathBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AvznCharacter;
+
+// One-off action fired when a script step starts
+namespace EClimbScriptAction
+{
+	enum Type : uint8
+	{
+		None,
+		Climb,				// Climb toggle, also starts vaults and climbing down ledges
+		Hop,
+		CrouchPressed,		// Slides when running
+		CrouchReleased,
+		InteractPressed,	// Grapples onto interactables
+		InteractReleased,
+		JumpPressed,		// Launches when stood on a launch pad
+		JumpReleased,
+		Reset				// Back to the start transform, walking and still, asked of the server when networked
+	};
+}
+
+struct FClimbScriptStep
+{
+	EClimbScriptAction::Type Action = EClimbScriptAction::None;
+	FVector2D MoveInput = FVector2D::ZeroVector; // Held for the whole step
+	float Duration = 0.f;
+};
+
+/** Timed sequence of inputs for driving an AvznCharacter without a player */
+struct VZN_API FClimbMovementScript
+{
+	TArray<FClimbScriptStep> Steps;
+
+	float GetTotalDuration() const;
+
+	// Slide, vault, climb, hop, ledge mantle and grapple along a lane built by the climb benchmark
+	static FClimbMovementScript MakeCourseLoop();
+
+	// Launch pad, switch and moving platform run-up, then the course loop, for lanes built with props by the bot load test
+	static FClimbMovementScript MakeBotLoop();
+};
+
+/** Plays a script on one character, looping back to the first step at the end */
+struct VZN_API FClimbMovementScriptPlayer
+{
+	int32 StepIndex = INDEX_NONE;
+	float StepTime = 0.f;
+	FTransform StartTransform = FTransform::Identity;
+
+	void Start(const FClimbMovementScript& InScript, const FTransform& InStartTransform, float InTimeOffset);
+
+	void Tick(AvznCharacter* InCharacter, const FClimbMovementScript& InScript, float DeltaTime);
+
+private:
+
+	void RunAction(AvznCharacter* InCharacter, EClimbScriptAction::Type InAction) const;
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "Components/CharacterMovementSnapshot.h"
 #include "CharacterAnimInstance.generated.h"
 
 class AvznCharacter;
@@ -21,7 +22,8 @@ public:
 
 	// Overriden functions for the anim blueprint
 	virtual void NativeInitializeAnimation() override;
-	virtual void NativeUpdateAnimation(float DeltaSeconds) override;
+	virtual void NativeUpdateAnimation(float DeltaSeconds) override; // Game thread, only copies the movement snapshot
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaSeconds) override; // Worker thread when the anim blueprint uses multi-threaded update
 
 private:
 
@@ -31,6 +33,8 @@ private:
 	UPROPERTY()
 	UCustomMovementComponent* CustomMovementComponent;
 
+	FCharacterMovementSnapshot MovementSnapshot; // Copy of the movement component's snapshot for this update, the only state the worker thread reads
+
 	// Properties for the animation blueprint
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Reference, meta = (AllowPrivateAccess = "true"))
 	float GroundSpeed;     // Speed on the ground
@@ -42,7 +46,7 @@ private:
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Reference, meta = (AllowPrivateAccess = "true"))
 	bool bShouldMove;      // Should the character move 
-	void GetShouldMove(); 
+	void GetShouldMove();
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Reference, meta = (AllowPrivateAccess = "true"))
 	bool bIsFalling;      
@@ -54,5 +58,5 @@ private:
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Reference, meta = (AllowPrivateAccess = "true"))
 	FVector ClimbVelocity;   // Climb speed
-	void GetClimbVelocity(); 
+	void GetClimbVelocity();
 };
\ No newline at end of file
@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/HitResult.h"
+#include "CollisionShape.h"
+#include "ClimbQuerySubsystem.generated.h"
+
+class UCustomMovementComponent;
+struct FCollisionObjectQueryParams;
+struct FCollisionQueryParams;
+
+// Order climbers are given their share of the frame's query budget in
+namespace EClimbQueryPriority
+{
+	enum Type : uint8
+	{
+		LocalPlayer,	// Never throttled, on the server every player whose client sends moves
+		Starved,		// Stale for too long or moved too far from its last results, never throttled either
+		Visible,		// Rendered recently
+		OffScreen
+	};
+}
+
+/** One climber's queries for the frame, the same set the async look-ahead traces cover plus the surface trace */
+struct FClimbBatchedQuery
+{
+	static constexpr int32 NumSceneQueries = 4;
+
+	UCustomMovementComponent* Component = nullptr;
+	EClimbQueryPriority::Type Priority = EClimbQueryPriority::OffScreen;
+	uint64 StaleFrames = 0; // Frames since this climber last got fresh results
+	float StaleDistance = 0.f; // Distance moved since then
+
+	// Filled by the component on the game thread, the params are owned by the component
+	const FCollisionObjectQueryParams* ObjectQueryParams = nullptr;
+	const FCollisionQueryParams* QueryParams = nullptr;
+	FCollisionShape Capsule;
+
+	FVector SurfaceStart = FVector::ZeroVector;
+	FVector SurfaceEnd = FVector::ZeroVector;
+	FVector FloorStart = FVector::ZeroVector;
+	FVector FloorEnd = FVector::ZeroVector;
+	FVector LedgeStart = FVector::ZeroVector;
+	FVector LedgeEnd = FVector::ZeroVector;
+	FVector LedgeWalkableEnd = FVector::ZeroVector; // Starts from LedgeEnd
+
+	// Filled on a worker thread, the arrays keep their capacity between frames
+	TArray<FHitResult> SurfaceHits;
+	TArray<FHitResult> FloorHits;
+	FHitResult LedgeHit;
+	FHitResult LedgeWalkableHit;
+
+	void Execute(const UWorld* InWorld);
+};
+
+/**
+ * Runs the climb queries of every climbing character as one parallel batch before actors tick, so PhysClimb finds its
+ * results waiting instead of tracing during its own tick. Past the climb.QueryBudget, lower priority climbers are
+ * throttled and reuse their last results for the frame, until they're too stale or have moved too far from them.
+ */
+UCLASS()
+class VZN_API UClimbQuerySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void RegisterComponent(UCustomMovementComponent* InComponent);
+	void UnregisterComponent(UCustomMovementComponent* InComponent);
+
+	FORCEINLINE int32 GetNumBatchedLastFrame() const { return NumBatchedLastFrame; }
+	FORCEINLINE int32 GetNumThrottledLastFrame() const { return NumThrottledLastFrame; }
+
+private:
+
+	void OnWorldPreActorTick(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds);
+
+	EClimbQueryPriority::Type GetPriority(const UCustomMovementComponent* InComponent) const;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UCustomMovementComponent>> Components;
+
+	TArray<FClimbBatchedQuery> Batch; // Kept between frames so the hit arrays don't reallocate
+
+	TArray<int32> BatchOrder;
+
+	FDelegateHandle PreActorTickHandle;
+
+	int32 NumBatchedLastFrame = 0;
+	int32 NumThrottledLastFrame = 0;
+};
@@ -0,0 +1,210 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+#include "Components/ClimbSurfaceSamples.h"
+#include "ClimbSurfaceIndex.generated.h"
+
+// A flat rectangle of climbable collision, baked from the box collision of static meshes
+USTRUCT()
+struct VZN_API FClimbSurfaceQuad
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector Center = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector3f Normal = FVector3f::ZeroVector;
+
+	// Unit axes along the quad, HalfExtents are measured along these
+	UPROPERTY()
+	FVector3f AxisU = FVector3f::ZeroVector;
+
+	UPROPERTY()
+	FVector3f AxisV = FVector3f::ZeroVector;
+
+	UPROPERTY()
+	FVector2f HalfExtents = FVector2f::ZeroVector;
+
+	UPROPERTY()
+	bool bWalkable = false; // Top surface the character can stand on after climbing up
+
+	FVector GetClosestPoint(const FVector& InPoint) const;
+
+	FBox GetBounds() const;
+};
+
+// One face triangle of a convex hull, so sloped and irregular hulls are baked as they are rather than as their bounding box
+USTRUCT()
+struct VZN_API FClimbSurfaceTriangle
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector A = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector B = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector C = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector3f Normal = FVector3f::ZeroVector; // Pointing out of the hull
+
+	UPROPERTY()
+	bool bWalkable = false;
+
+	FVector GetClosestPoint(const FVector& InPoint) const;
+
+	bool ContainsPlanePoint(const FVector& InPoint) const; // For a point already on the triangle's plane
+
+	FBox GetBounds() const;
+};
+
+// Outer edge of a walkable top surface, where a climb ends in a mantle
+USTRUCT()
+struct VZN_API FClimbLedgeEdge
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector Start = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector End = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector3f WallNormal = FVector3f::ZeroVector; // Normal of the wall below the edge, pointing away from the top surface
+};
+
+// Precomputed hop and mantle results for a patch of climbable wall, offsets are from the wall point to the warp target
+USTRUCT()
+struct VZN_API FClimbHopCell
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector3f WallNormal = FVector3f::ZeroVector;
+
+	UPROPERTY()
+	FVector3f HopUpOffset = FVector3f::ZeroVector;
+
+	UPROPERTY()
+	FVector3f HopDownOffset = FVector3f::ZeroVector;
+
+	UPROPERTY()
+	bool bCanHopUp = false;
+
+	UPROPERTY()
+	bool bCanHopDown = false;
+
+	UPROPERTY()
+	bool bCanMantle = false;
+};
+
+// One occupied grid cell, pointing into the flattened item list
+USTRUCT()
+struct VZN_API FClimbSurfaceIndexCell
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FIntVector Coord = FIntVector::ZeroValue;
+
+	UPROPERTY()
+	int32 FirstItem = 0;
+
+	UPROPERTY()
+	int32 NumItems = 0;
+};
+
+/**
+ * Baked spatial index of the climbable static collision in a region of the level.
+ * Occupied grid cells are sorted so a lookup is a binary search, and each cell lists the quads and triangles overlapping it.
+ * Only geometry that can't move is baked, anything movable still has to be traced live. Static collision the bake can't
+ * represent exactly is recorded as unbaked bounds, and queries touching those aren't answered from the index at all.
+ */
+USTRUCT()
+struct VZN_API FClimbSurfaceIndex
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FBox Bounds = FBox(ForceInit);
+
+	UPROPERTY()
+	float CellSize = 200.f;
+
+	UPROPERTY()
+	TArray<FClimbSurfaceQuad> Quads;
+
+	UPROPERTY()
+	TArray<FClimbSurfaceTriangle> Triangles;
+
+	UPROPERTY()
+	TArray<FClimbLedgeEdge> LedgeEdges;
+
+	// Spheres, capsules, complex collision, landscape, BSP and anything else that isn't boxes or convex hulls
+	UPROPERTY()
+	TArray<FBox> UnbakedBounds;
+
+	UPROPERTY()
+	TArray<FClimbSurfaceIndexCell> Cells;
+
+	// Items below Quads.Num() are quads, the rest are triangles numbered after them
+	UPROPERTY()
+	TArray<int32> CellItems;
+
+	UPROPERTY()
+	float HopCellSize = 25.f;
+
+	// Climber the hop table was baked for, a character with a different eye height or capsule radius probes live
+	UPROPERTY()
+	float HopEyeHeight = 0.f;
+
+	UPROPERTY()
+	float HopWallStandOff = 0.f;
+
+	// Hop and mantle table keyed by the quantized wall point, see GetHopCellCoord
+	UPROPERTY()
+	TMap<FIntVector, FClimbHopCell> HopCells;
+
+	bool IsEmpty() const { return Quads.IsEmpty() && Triangles.IsEmpty(); }
+
+	// Inside the baked bounds and clear of anything that wasn't baked
+	bool Covers(const FBox& InBox) const;
+
+	// Capsule overlap at the end of the (short) sweep, writes a sample for every face within the capsule radius
+	bool OverlapCapsule(const FVector& InCenter, float InRadius, float InHalfHeight, FClimbSurfaceSamples& OutSamples) const;
+
+	// Nearest front facing quad or triangle along the segment
+	bool Raycast(const FVector& InStart, const FVector& InEnd, FHitResult& OutHit) const;
+
+	// Rebuild the cell lists from Quads and Triangles, used by the bake
+	void BuildCells(float InCellSize);
+
+	FIntVector GetCellCoord(const FVector& InLocation) const;
+
+	const FClimbSurfaceIndexCell* FindCell(const FIntVector& InCoord) const;
+
+	// The wall point is pushed half a cell out along its normal first, so the two faces of a thin wall land in different cells
+	FIntVector GetHopCellCoord(const FVector& InWallPoint, const FVector& InWallNormal) const;
+
+	// Null if the wall point isn't baked or the baked wall faces another way
+	const FClimbHopCell* FindHopCell(const FVector& InWallPoint, const FVector& InWallNormal) const;
+
+	// Whether the hop table was baked for a climber with this eye height and distance from the wall
+	bool HasHopCellsFor(float InEyeHeight, float InWallStandOff) const;
+
+private:
+
+	// Collect the items in every cell the box touches, without duplicates
+	template<typename AllocatorType>
+	void GatherItems(const FBox& InBox, TArray<int32, AllocatorType>& OutItems) const;
+
+	void AddItemToCells(const FBox& InItemBounds, int32 InItem, TMap<FIntVector, TArray<int32>>& InOutItemsByCell) const;
+};
@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Engine/EngineTypes.h"
+#include "ClimbSurfaceIndex.h"
+#include "ClimbSurfaceIndexActor.generated.h"
+
+class UBoxComponent;
+class ACharacter;
+class UBodySetup;
+struct FKConvexElem;
+
+/**
+ * Holds the baked climbable surface index for the region covered by its box.
+ * Place one per area of the level and run Bake in the editor, the index is saved with the actor
+ * and registers itself with the climb index subsystem when the actor streams in.
+ */
+UCLASS()
+class VZN_API AClimbSurfaceIndexActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this actor's properties
+	AClimbSurfaceIndexActor();
+
+	FORCEINLINE const FClimbSurfaceIndex& GetIndex() const { return Index; }
+
+	TArray<ECollisionChannel, TInlineAllocator<4>> GetClimbableChannels() const;
+
+#if WITH_EDITOR
+	// Walk the climbable collision that can't move inside the bounds and rebuild the index
+	UFUNCTION(CallInEditor, Category = "Climb Index")
+	void Bake();
+#endif
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+
+	UPROPERTY(EditDefaultsOnly, Category = "Components") UBoxComponent* BakeBounds;
+
+	// Object types that count as climbable, should match the character's ClimbableSurfaceTraceTypes
+	UPROPERTY(EditAnywhere, Category = "Climb Index")
+	TArray < TEnumAsByte<EObjectTypeQuery> > ClimbableSurfaceTraceTypes;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Index", meta = (ClampMin = "25.0"))
+	float CellSize = 200.f;
+
+	// Top surfaces flatter than this are walkable, same 60 degrees the climb ledge check uses
+	UPROPERTY(EditAnywhere, Category = "Climb Index")
+	float MaxWalkableAngle = 60.f;
+
+	// Hop and mantle table, the probes mirror the eye height traces UCustomMovementComponent would otherwise fire
+	UPROPERTY(EditAnywhere, Category = "Climb Index|Hops")
+	bool bBakeHopTargets = true;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Index|Hops", meta = (ClampMin = "5.0", EditCondition = "bBakeHopTargets"))
+	float HopCellSize = 25.f;
+
+	// Eye height and capsule radius are read from this class, the table is only used by climbers that match it
+	UPROPERTY(EditAnywhere, Category = "Climb Index|Hops", meta = (EditCondition = "bBakeHopTargets"))
+	TSubclassOf<ACharacter> ClimbingCharacterClass;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Index|Hops", meta = (EditCondition = "bBakeHopTargets"))
+	float EyeTraceDistance = 100.f;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Index|Hops", meta = (EditCondition = "bBakeHopTargets"))
+	float HopUpOffset = -20.f;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Index|Hops", meta = (EditCondition = "bBakeHopTargets"))
+	float HopUpSafetyLedgeOffset = 150.f;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Index|Hops", meta = (EditCondition = "bBakeHopTargets"))
+	float HopDownOffset = -300.f;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Index|Hops", meta = (EditCondition = "bBakeHopTargets"))
+	float MantleOffset = 50.f;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Index|Hops", meta = (EditCondition = "bBakeHopTargets"))
+	float MantleWalkableTraceDistance = 100.f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Index")
+	FClimbSurfaceIndex Index;
+
+#if WITH_EDITOR
+	// Boxes and convex hulls are baked exactly, false when the body has collision the index can't represent
+	static bool CanBakeBodySetup(const UBodySetup* InBodySetup);
+
+	void AddBodySetup(const UBodySetup& InBodySetup, const FTransform& InComponentTransform, float InWalkableCos);
+
+	void AddBoxFaces(const FTransform& InBoxTransform, const FVector& InHalfExtents, float InWalkableCos);
+
+	void AddConvexFaces(const FKConvexElem& InConvexElem, const FTransform& InElemTransform, float InWalkableCos);
+
+	void BakeHopCells(float InWalkableCos); // Needs the quads, triangles and cells to be built already
+
+	void BakeHopCellsOnFace(const FVector& InOrigin, const FVector& InAxisU, const FVector& InAxisV, const FVector2D& InMin, const FVector2D& InMax,
+		const FVector& InNormal, float InWalkableCos, TFunctionRef<bool(const FVector&)> InContains);
+
+	bool EvaluateHopCell(const FVector& InWallPoint, const FVector& InWallNormal, float InWalkableCos, FClimbHopCell& OutHopCell) const;
+#endif
+};
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ClimbSurfaceIndexSubsystem.generated.h"
+
+class AClimbSurfaceIndexActor;
+class UPrimitiveComponent;
+struct FClimbSurfaceIndex;
+struct FClimbHopCell;
+
+/**
+ * Keeps track of the baked climb indices that are currently loaded, so the movement component can find the one covering a query.
+ * Also keeps the movable climbable primitives, the only ones a baked index doesn't know about, so a query that can't touch
+ * any of them skips the physics scene entirely.
+ */
+UCLASS()
+class VZN_API UClimbSurfaceIndexSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void RegisterIndex(AClimbSurfaceIndexActor* InIndexActor);
+	void UnregisterIndex(AClimbSurfaceIndexActor* InIndexActor);
+
+	// Index whose bounds fully contain the query, null if the query has to be traced live
+	const FClimbSurfaceIndex* FindIndex(const FBox& InQueryBounds) const;
+
+	// Baked hop and mantle results for a point on a climbable wall, from an index baked for a climber of this size
+	const FClimbHopCell* FindHopCell(const FVector& InWallPoint, const FVector& InWallNormal, float InEyeHeight, float InWallStandOff) const;
+
+	// Whether anything movable and climbable is inside the box right now, in which case the live query is still needed
+	bool OverlapsMovableClimbable(const FBox& InQueryBounds) const;
+
+	FORCEINLINE bool HasIndices() const { return !IndexActors.IsEmpty(); }
+
+private:
+
+	void RebuildMovableClimbables();
+
+	void AddMovableClimbables(const AActor* InActor);
+
+	void OnActorSpawned(AActor* InActor);
+
+	void OnLevelAddedToWorld(ULevel* InLevel, UWorld* InWorld);
+
+	UPROPERTY()
+	TArray<TObjectPtr<AClimbSurfaceIndexActor>> IndexActors;
+
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> MovableClimbables;
+
+	TArray<ECollisionChannel, TInlineAllocator<4>> ClimbableChannels; // Union of the index actors' climbable object types
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle LevelAddedHandle;
+};
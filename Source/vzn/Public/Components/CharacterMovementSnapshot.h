@@ -0,0 +1,19 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Movement state the anim instance reads, published by the movement component at the end of its tick.
+ * Copied by value on the game thread, so the animation update can run on a worker thread without touching the character.
+ */
+struct FCharacterMovementSnapshot
+{
+	FVector Velocity = FVector::ZeroVector;
+	FVector UnrotatedClimbVelocity = FVector::ZeroVector; // Velocity in the capsule's space, for the climb blend space
+
+	bool bHasAcceleration = false;
+	bool bIsFalling = false;
+	bool bIsClimbing = false;
+};
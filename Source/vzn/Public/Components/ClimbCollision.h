@@ -0,0 +1,12 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+
+// Object channel only the generated climb proxies use, named "Climb" in DefaultEngine.ini
+#define ECC_Climb ECC_GameTraceChannel2
+
+// Collision profile for the climb proxies, query only and ignored by every other channel
+inline const FName ClimbProxyProfileName(TEXT("ClimbProxy"));
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+#include "Components/ClimbSurfaceSamples.h"
+
+// Probe groups the environment snapshot can resolve, each group is traced at most once per frame
+namespace EClimbProbe
+{
+	enum Type : uint8
+	{
+		Surface			= 1 << 0, // Capsule trace in front of the character
+		EyeClimb		= 1 << 1, // Eye height trace used to start climbing
+		EyeHopUp		= 1 << 2, // Eye height trace for the hop up target
+		EyeSafetyLedge	= 1 << 3, // Eye height trace above the hop up target
+		EyeHopDown		= 1 << 4, // Eye height trace for the hop down target
+		ClimbDownLedge	= 1 << 5, // Walkable surface and ledge traces in front of the feet
+		Vault			= 1 << 6  // Downward vault sample traces
+	};
+}
+
+/**
+ * Per-frame cache of the probes taken around the capsule.
+ * Every climb, ledge, vault and hop predicate reads from here, so however many of them run in a frame
+ * the scene is only queried once per probe group.
+ */
+struct FClimbEnvironmentSnapshot
+{
+	static constexpr int32 NumVaultSamples = 5;
+
+	// Frame and transform the probes were taken from
+	uint64 FrameNumber = MAX_uint64;
+	FVector ComponentLocation = FVector::ZeroVector;
+	FQuat ComponentQuat = FQuat::Identity;
+
+	// Which of the EClimbProbe groups have been traced for this frame
+	uint8 ProbedMask = 0;
+
+	FClimbSurfaceSamples SurfaceSamples;
+
+	FHitResult EyeClimbHit;
+	FHitResult EyeHopUpHit;
+	FHitResult EyeSafetyLedgeHit;
+	FHitResult EyeHopDownHit;
+
+	FHitResult ClimbDownWalkableHit;
+	FHitResult ClimbDownLedgeHit;
+
+	FHitResult VaultHits[NumVaultSamples];
+
+	bool IsValidFor(uint64 InFrameNumber, const FVector& InLocation, const FQuat& InQuat) const
+	{
+		return FrameNumber == InFrameNumber && ComponentLocation.Equals(InLocation) && ComponentQuat.Equals(InQuat);
+	}
+
+	bool HasProbed(uint8 InProbes) const { return (ProbedMask & InProbes) == InProbes; }
+
+	void Reset(uint64 InFrameNumber, const FVector& InLocation, const FQuat& InQuat)
+	{
+		FrameNumber = InFrameNumber;
+		ComponentLocation = InLocation;
+		ComponentQuat = InQuat;
+		ProbedMask = 0;
+		SurfaceSamples.Reset(InLocation);
+	}
+};
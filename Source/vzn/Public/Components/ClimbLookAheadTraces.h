@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WorldCollision.h"
+#include "Components/ClimbSurfaceSamples.h"
+#include "Components/ClimbSurfaceCache.h"
+
+// Identifies which look-ahead trace a delegate call is for
+namespace EClimbLookAheadTrace
+{
+	enum Type : uint32
+	{
+		Floor,
+		Ledge,
+		LedgeWalkable
+	};
+}
+
+/**
+ * Async ledge and floor traces issued at the end of one PhysClimb tick from where the character is predicted to be,
+ * and picked up by the next tick instead of tracing synchronously on the game thread.
+ * UClimbQuerySubsystem fills the same results, plus the surface trace, from its batch before the tick instead.
+ */
+struct FClimbLookAheadTraces
+{
+	FTraceHandle FloorHandle;
+	FTraceHandle LedgeHandle;
+	FTraceHandle LedgeWalkableHandle;
+
+	// Predicted capsule transform each trace was issued from, the surface trace is taken from the floor location
+	FVector FloorLocation = FVector::ZeroVector;
+	FVector LedgeLocation = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+
+	uint64 UsableFrame = 0; // Frame whose PhysClimb may pick the results up
+	bool bSurfacePending = false;
+	bool bFloorPending = false;
+	bool bLedgePending = false;
+
+	// Results copied out of the trace delegates into storage that keeps its capacity between ticks
+	FClimbSurfaceSamples SurfaceSamples;
+	FClimbCachedQuery SurfaceQuery; // Only used to track the primitives the surface trace hit
+	FClimbSurfaceSamples FloorSamples;
+	FClimbCachedQuery FloorQuery; // Only used to track the primitives the floor trace hit
+	FHitResult LedgeHit;
+	FHitResult LedgeWalkableHit;
+	bool bSurfaceReady = false;
+	bool bFloorReady = false;
+	bool bLedgeReady = false;
+	bool bLedgeWalkableReady = false;
+
+	// How often the prediction was used, and how often we had to fall back to a synchronous trace
+	uint32 NumPredictionsUsed = 0;
+	uint32 NumPredictionFallbacks = 0;
+
+	void Invalidate()
+	{
+		bSurfacePending = false;
+		bFloorPending = false;
+		bLedgePending = false;
+		bSurfaceReady = false;
+		bFloorReady = false;
+		bLedgeReady = false;
+		bLedgeWalkableReady = false;
+	}
+};
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ClimbSurfaceSamples.h"
+
+/**
+ * Climb maths with no scene or UObject dependencies, everything comes in as plain values.
+ * The movement component gathers its inputs from UpdatedComponent and the trace results and calls into here,
+ * so the kernels can be benchmarked on synthetic data without a world (see UClimbMathBenchmarkCommandlet).
+ */
+namespace ClimbMath
+{
+	// Location and normal of the surface the character is climbing, from the samples of the surface trace.
+	// False when the samples don't give a usable normal, the outputs shouldn't be used then
+	inline bool ResolveSurface(
+		const FClimbSurfaceSamples& InSamples,
+		bool bInPlaneFit,
+		const FVector& InReferencePoint,
+		const FClimbPlaneFitSettings& InSettings,
+		FVector& OutLocation,
+		FVector& OutNormal)
+	{
+		if (!bInPlaneFit)
+		{
+			InSamples.ComputeAverage(OutLocation, OutNormal);
+			return !OutNormal.IsZero(); // Empty, or normals cancelling out
+		}
+
+		return InSamples.FitPlane(InReferencePoint, InSettings, OutLocation, OutNormal);
+	}
+
+	// True if the surface is flat enough to stand on, compared against the cosine of the max angle rather than taking an Acos
+	FORCEINLINE bool IsWalkableNormal(const FVector& InNormal, const FVector& InUp, float InMaxAngleCos)
+	{
+		return FVector::DotProduct(InNormal, InUp) >= InMaxAngleCos;
+	}
+
+	// Movement pulling the character onto the surface, along the surface normal by how far the surface is in front
+	FORCEINLINE FVector GetSnapDelta(
+		const FVector& InSurfaceLocation,
+		const FVector& InSurfaceNormal,
+		const FVector& InComponentLocation,
+		const FVector& InComponentForward,
+		float InDeltaTime,
+		float InSnapSpeed)
+	{
+		// Length of the projection onto a unit forward is the absolute forward distance
+		const double ForwardDistance = FMath::Abs(FVector::DotProduct(InSurfaceLocation - InComponentLocation, InComponentForward));
+
+		return -InSurfaceNormal * (ForwardDistance * InDeltaTime * InSnapSpeed);
+	}
+
+	// Facing into the surface, with the up axis as close to world up as the normal allows
+	FORCEINLINE FQuat GetClimbTargetQuat(const FVector& InSurfaceNormal)
+	{
+		return FRotationMatrix::MakeFromX(-InSurfaceNormal).ToQuat();
+	}
+
+	FORCEINLINE FQuat InterpClimbRotation(const FQuat& InCurrentQuat, const FVector& InSurfaceNormal, float InDeltaTime, float InInterpSpeed)
+	{
+		return FMath::QInterpTo(InCurrentQuat, GetClimbTargetQuat(InSurfaceNormal), InDeltaTime, InInterpSpeed);
+	}
+
+	/** Vault probes: downward lines further ahead and longer for each sample, the first landing on the obstacle and the last past it */
+	struct FVaultPattern
+	{
+		float Height = 100.f;	// Above the component location
+		float Spacing = 80.f;	// Forward distance between samples
+		float Depth = 100.f;	// Trace length per sample index
+	};
+
+	FORCEINLINE void GetVaultSample(
+		const FVector& InComponentLocation,
+		const FVector& InForward,
+		const FVector& InUp,
+		const FVaultPattern& InPattern,
+		int32 InIndex,
+		FVector& OutStart,
+		FVector& OutEnd)
+	{
+		const float Step = static_cast<float>(InIndex + 1);
+
+		OutStart = InComponentLocation + InUp * InPattern.Height + InForward * (InPattern.Spacing * Step);
+		OutEnd = OutStart - InUp * (InPattern.Depth * Step);
+	}
+
+	// Needs both the first and last sample to have landed on something
+	FORCEINLINE bool EvaluateVault(
+		bool bInFirstHit,
+		const FVector& InFirstImpact,
+		bool bInLastHit,
+		const FVector& InLastImpact,
+		FVector& OutVaultStart,
+		FVector& OutVaultEnd)
+	{
+		OutVaultStart = bInFirstHit ? InFirstImpact : FVector::ZeroVector;
+		OutVaultEnd = bInLastHit ? InLastImpact : FVector::ZeroVector;
+
+		return OutVaultStart != FVector::ZeroVector && OutVaultEnd != FVector::ZeroVector;
+	}
+}
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ClimbProxyComponent.generated.h"
+
+class UPrimitiveComponent;
+class UStaticMeshComponent;
+
+/**
+ * Generates proxies on the ClimbProxy profile for the climbable static meshes of its owner.
+ * Meshes whose collision is all boxes get a box per element, anything else (convex hulls, round shapes, complex only)
+ * gets a hidden copy of the mesh so the proxy has exactly the same collision.
+ * With bTraceClimbProxiesOnly on the movement component, climb traces only test these proxies,
+ * so they skip anything decorative that has no proxy.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class VZN_API UClimbProxyComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UClimbProxyComponent();
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+
+	void BuildProxies();
+
+	void BuildMeshProxies(UStaticMeshComponent* InMesh);
+
+	void AddBoxProxy(UStaticMeshComponent* InMesh, const FTransform& InRelativeTransform, const FVector& InExtent);
+
+	void AddMeshProxy(UStaticMeshComponent* InMesh);
+
+	void AddProxy(UPrimitiveComponent* InProxy, UStaticMeshComponent* InMesh, const FTransform& InRelativeTransform);
+
+	// Only meshes with this component tag get proxies, every static mesh on the owner when none
+	UPROPERTY(EditAnywhere, Category = "Climb Proxy")
+	FName MeshTag;
+
+	// One box around each mesh instead of one per simple collision element
+	UPROPERTY(EditAnywhere, Category = "Climb Proxy")
+	bool bUseMeshBoundsOnly = false;
+
+	// Flat collision elements are thickened to this so capsule sweeps can't skip through them
+	UPROPERTY(EditAnywhere, Category = "Climb Proxy", meta = (ClampMin = "0.0"))
+	float MinProxyExtent = 2.f;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UPrimitiveComponent>> Proxies;
+};
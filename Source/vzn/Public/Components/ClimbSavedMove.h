@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+/**
+ * Saved move carrying the climb, slide and grapple intents to the server. The intents ride in the compressed flags next to jump and
+ * crouch, so a climbing move costs the same bytes as a walking one.
+ */
+class VZN_API FSavedMove_Climb : public FSavedMove_Character
+{
+	typedef FSavedMove_Character Super;
+
+public:
+
+	enum EClimbCompressedFlags
+	{
+		FLAG_Climb = FLAG_Custom_0,
+		FLAG_Hop = FLAG_Custom_1,
+		FLAG_Slide = FLAG_Custom_2,
+		FLAG_Grapple = FLAG_Custom_3
+	};
+
+	uint8 bSavedWantsToClimb : 1;
+	uint8 bSavedWantsToHop : 1;
+	uint8 bSavedClimbing : 1;
+	uint8 bSavedWantsToSlide : 1;
+	uint8 bSavedWantsToGrapple : 1;
+	uint8 bSavedGrappling : 1;
+
+	FVector SavedClimbSurfaceNormal = FVector::ZeroVector; // Client side only, for combining and replays
+	float SavedClimbStepAccumulator = 0.f; // Client side only, the fixed step remainder the move started with
+
+	FVector SavedGrappleAnchor = FVector::ZeroVector; // Sent in the move data while the grapple is held
+
+	FVector SavedGrappleRopeAnchor = FVector::ZeroVector; // Client side only, the swing's state for replays
+	float SavedGrappleRopeLength = 0.f;
+
+	FSavedMove_Climb();
+
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual void CombineWith(const FSavedMove_Character* OldMove, ACharacter* InCharacter, APlayerController* PC, const FVector& OldStartLocation) override;
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+	virtual void PrepMoveFor(ACharacter* C) override;
+};
+
+// Move data for the server RPCs, adds the grapple anchor to moves that hold the grapple
+struct VZN_API FCharacterNetworkMoveData_Climb : public FCharacterNetworkMoveData
+{
+	typedef FCharacterNetworkMoveData Super;
+
+	FVector_NetQuantize10 GrappleAnchor;
+
+	virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+};
+
+struct VZN_API FCharacterNetworkMoveDataContainer_Climb : public FCharacterNetworkMoveDataContainer
+{
+	FCharacterNetworkMoveDataContainer_Climb();
+
+	FCharacterNetworkMoveData_Climb ClimbMoveData[3]; // New, pending and old moves
+};
+
+class VZN_API FNetworkPredictionData_Client_Climb : public FNetworkPredictionData_Client_Character
+{
+	typedef FNetworkPredictionData_Client_Character Super;
+
+public:
+
+	FNetworkPredictionData_Client_Climb(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
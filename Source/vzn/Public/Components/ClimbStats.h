@@ -0,0 +1,9 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+// Stat group for the climbing movement, use "stat Climb" to view it in game
+DECLARE_STATS_GROUP(TEXT("Climb"), STATGROUP_Climb, STATCAT_Advanced);
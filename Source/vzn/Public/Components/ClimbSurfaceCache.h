@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/ClimbSurfaceSamples.h"
+
+/**
+ * Remembers where a group of climb traces was taken from and which primitives it hit.
+ * The results stay valid while the capsule is within the distance/angle tolerance of that transform
+ * and none of the hit primitives have moved.
+ */
+struct FClimbCachedQuery
+{
+	struct FTrackedPrimitive
+	{
+		TWeakObjectPtr<const UPrimitiveComponent> Component;
+		FPrimitiveComponentId PrimitiveId;
+		FTransform Transform;
+	};
+
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	bool bValid = false;
+
+	int32 NumSceneQueries = 1; // How many scene queries a reuse of this group saves
+
+	TArray<FTrackedPrimitive, TInlineAllocator<4>> Primitives;
+
+	void Capture(const FVector& InLocation, const FQuat& InRotation, int32 InNumSceneQueries)
+	{
+		Location = InLocation;
+		Rotation = InRotation;
+		NumSceneQueries = InNumSceneQueries;
+		bValid = true;
+		Primitives.Reset();
+	}
+
+	void TrackHit(const FHitResult& Hit)
+	{
+		const UPrimitiveComponent* HitComponent = Hit.GetComponent();
+		if (!HitComponent) return;
+
+		for (const FTrackedPrimitive& Tracked : Primitives)
+		{
+			if (Tracked.PrimitiveId == HitComponent->ComponentId) return;
+		}
+
+		Primitives.Add({ HitComponent, HitComponent->ComponentId, HitComponent->GetComponentTransform() });
+	}
+
+	void Invalidate() { bValid = false; }
+
+	bool IsReusable(const FVector& InLocation, const FQuat& InRotation, float MaxDistance, float MaxAngleDegrees) const
+	{
+		if (!bValid) return false;
+		if (FVector::DistSquared(InLocation, Location) > FMath::Square(MaxDistance)) return false;
+		if (FMath::RadiansToDegrees(InRotation.AngularDistance(Rotation)) > MaxAngleDegrees) return false;
+
+		// Static primitives can't move, anything else has to still be where it was when we traced it
+		for (const FTrackedPrimitive& Tracked : Primitives)
+		{
+			const UPrimitiveComponent* Component = Tracked.Component.Get();
+			if (!Component) return false;
+			if (Component->Mobility == EComponentMobility::Static) continue;
+			if (!Component->GetComponentTransform().Equals(Tracked.Transform)) return false;
+		}
+
+		return true;
+	}
+};
+
+/** Temporal cache for the traces PhysClimb runs every tick, so a character hanging still on a wall doesn't keep re-tracing it */
+struct FClimbSurfaceCache
+{
+	// Capsule trace for climbable surfaces, with the location and normal processed from it
+	FClimbCachedQuery SurfaceQuery;
+	FVector SurfaceLocation = FVector::ZeroVector;
+	FVector SurfaceNormal = FVector::ZeroVector;
+
+	// Capsule trace below the character for the floor
+	FClimbCachedQuery FloorQuery;
+	FClimbSurfaceSamples FloorSamples;
+
+	// Eye height and walkable surface traces for the ledge
+	FClimbCachedQuery LedgeQuery;
+	FHitResult LedgeHit;
+	FHitResult LedgeWalkableHit;
+
+	// Counters for how often the cache saved us a trace
+	uint32 NumHits = 0;
+	uint32 NumMisses = 0;
+	uint32 NumSavedSceneQueries = 0;
+
+	void Invalidate()
+	{
+		SurfaceQuery.Invalidate();
+		FloorQuery.Invalidate();
+		LedgeQuery.Invalidate();
+	}
+};
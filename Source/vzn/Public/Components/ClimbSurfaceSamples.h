@@ -0,0 +1,439 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/VectorRegister.h"
+
+/** One climbable surface contact, only the parts of a hit the climb maths actually reads */
+struct FClimbSurfaceSample
+{
+	FVector Point = FVector::ZeroVector;
+	FVector Normal = FVector::ZeroVector;
+	uint32 PrimitiveId = 0;
+};
+
+/** Tuning for FClimbSurfaceSamples::FitPlane */
+struct FClimbPlaneFitSettings
+{
+	float WeightFalloff = 50.f;		// Distance from the reference point at which a sample counts half as much
+	float OutlierDistance = 10.f;	// Samples further than this from the first fit are rejected
+	float OutlierAngleCos = 0.866f;	// Samples whose normal is further than this from the first fit are rejected
+	float MinSpread = 2.f;			// Below this the points don't span a plane, so the weighted normal is used instead
+	float MaxFitAngleCos = 0.707f;	// The fitted normal has to stay this close to the weighted sample normals
+};
+
+/**
+ * Fixed capacity struct-of-arrays buffer of climb surface samples, stored inline in the owning component.
+ * Points are kept in single precision relative to Origin so the kernels can run four samples per vector register.
+ */
+struct FClimbSurfaceSamples
+{
+	static constexpr int32 Capacity = 16; // Multiple of four so the kernels never read past the arrays
+
+	FVector Origin = FVector::ZeroVector;
+	int32 Num = 0;
+
+	alignas(16) float PointX[Capacity];
+	alignas(16) float PointY[Capacity];
+	alignas(16) float PointZ[Capacity];
+
+	alignas(16) float NormalX[Capacity];
+	alignas(16) float NormalY[Capacity];
+	alignas(16) float NormalZ[Capacity];
+
+	uint32 PrimitiveIds[Capacity];
+
+	void Reset(const FVector& InOrigin)
+	{
+		Origin = InOrigin;
+		Num = 0;
+	}
+
+	bool IsEmpty() const { return Num == 0; }
+
+	bool Add(const FVector& InPoint, const FVector& InNormal, uint32 InPrimitiveId) // Returns false once the buffer is full
+	{
+		if (Num >= Capacity) return false;
+
+		const FVector LocalPoint = InPoint - Origin;
+
+		PointX[Num] = static_cast<float>(LocalPoint.X);
+		PointY[Num] = static_cast<float>(LocalPoint.Y);
+		PointZ[Num] = static_cast<float>(LocalPoint.Z);
+
+		NormalX[Num] = static_cast<float>(InNormal.X);
+		NormalY[Num] = static_cast<float>(InNormal.Y);
+		NormalZ[Num] = static_cast<float>(InNormal.Z);
+
+		PrimitiveIds[Num] = InPrimitiveId;
+		Num++;
+
+		return true;
+	}
+
+	FVector GetPoint(int32 Index) const { return Origin + FVector(PointX[Index], PointY[Index], PointZ[Index]); }
+	FVector GetNormal(int32 Index) const { return FVector(NormalX[Index], NormalY[Index], NormalZ[Index]); }
+
+	FClimbSurfaceSample GetSample(int32 Index) const { return { GetPoint(Index), GetNormal(Index), PrimitiveIds[Index] }; }
+
+	// Average of the sample points and the normalised sum of the sample normals
+	void ComputeAverage(FVector& OutLocation, FVector& OutNormal) const
+	{
+		OutLocation = FVector::ZeroVector;
+		OutNormal = FVector::ZeroVector;
+
+		if (IsEmpty()) return;
+
+		VectorRegister4Float SumPointX = VectorZeroFloat();
+		VectorRegister4Float SumPointY = VectorZeroFloat();
+		VectorRegister4Float SumPointZ = VectorZeroFloat();
+		VectorRegister4Float SumNormalX = VectorZeroFloat();
+		VectorRegister4Float SumNormalY = VectorZeroFloat();
+		VectorRegister4Float SumNormalZ = VectorZeroFloat();
+
+		int32 Index = 0;
+
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			SumPointX = VectorAdd(SumPointX, VectorLoad(PointX + Index));
+			SumPointY = VectorAdd(SumPointY, VectorLoad(PointY + Index));
+			SumPointZ = VectorAdd(SumPointZ, VectorLoad(PointZ + Index));
+			SumNormalX = VectorAdd(SumNormalX, VectorLoad(NormalX + Index));
+			SumNormalY = VectorAdd(SumNormalY, VectorLoad(NormalY + Index));
+			SumNormalZ = VectorAdd(SumNormalZ, VectorLoad(NormalZ + Index));
+		}
+
+		FVector3f SumPoint(HorizontalSum(SumPointX), HorizontalSum(SumPointY), HorizontalSum(SumPointZ));
+		FVector3f SumNormal(HorizontalSum(SumNormalX), HorizontalSum(SumNormalY), HorizontalSum(SumNormalZ));
+
+		for (; Index < Num; Index++)
+		{
+			SumPoint += FVector3f(PointX[Index], PointY[Index], PointZ[Index]);
+			SumNormal += FVector3f(NormalX[Index], NormalY[Index], NormalZ[Index]);
+		}
+
+		OutLocation = Origin + FVector(SumPoint / static_cast<float>(Num));
+		OutNormal = FVector(SumNormal).GetSafeNormal();
+	}
+
+	// True if any sample normal is parallel to the axis, in either direction
+	bool AnyNormalParallelTo(const FVector& InAxis, float ParallelCosineThreshold = THRESH_NORMALS_ARE_PARALLEL) const
+	{
+		const VectorRegister4Float AxisX = VectorSetFloat1(static_cast<float>(InAxis.X));
+		const VectorRegister4Float AxisY = VectorSetFloat1(static_cast<float>(InAxis.Y));
+		const VectorRegister4Float AxisZ = VectorSetFloat1(static_cast<float>(InAxis.Z));
+		const VectorRegister4Float Threshold = VectorSetFloat1(ParallelCosineThreshold);
+
+		int32 Index = 0;
+
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			VectorRegister4Float Dot = VectorMultiply(VectorLoad(NormalX + Index), AxisX);
+			Dot = VectorMultiplyAdd(VectorLoad(NormalY + Index), AxisY, Dot);
+			Dot = VectorMultiplyAdd(VectorLoad(NormalZ + Index), AxisZ, Dot);
+
+			if (VectorMaskBits(VectorCompareGE(VectorAbs(Dot), Threshold)) != 0)
+			{
+				return true;
+			}
+		}
+
+		for (; Index < Num; Index++)
+		{
+			if (FMath::Abs(FVector::DotProduct(GetNormal(Index), InAxis)) >= ParallelCosineThreshold)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * Distance weighted least squares plane through the sample points, refit once without the outliers of the first pass.
+	 * Falls back to the weighted sample normals when the inliers don't span a plane, e.g. a single hit or hits along one edge.
+	 * Returns false if there were no usable samples.
+	 */
+	bool FitPlane(const FVector& InReferencePoint, const FClimbPlaneFitSettings& InSettings, FVector& OutLocation, FVector& OutNormal) const
+	{
+		OutLocation = FVector::ZeroVector;
+		OutNormal = FVector::ZeroVector;
+
+		if (IsEmpty()) return false;
+
+		alignas(16) float Weights[Capacity];
+		ComputeDistanceWeights(FVector3f(InReferencePoint - Origin), InSettings.WeightFalloff, Weights);
+
+		FVector3f Centroid;
+		FVector3f Normal;
+
+		if (!SolvePlane(AccumulateMoments(Weights, Num), InSettings, Centroid, Normal)) return false;
+
+		// Drop anything that doesn't agree with the first fit and solve again with what's left
+		const int32 NumInliers = RejectOutliers(Centroid, Normal, InSettings, Weights);
+
+		if (NumInliers > 0 && NumInliers < Num)
+		{
+			SolvePlane(AccumulateMoments(Weights, NumInliers), InSettings, Centroid, Normal);
+		}
+
+		OutLocation = Origin + FVector(Centroid);
+		OutNormal = FVector(Normal);
+
+		return true;
+	}
+
+private:
+
+	// Weighted sums over the samples, enough to get the centroid, the covariance of the points and the mean normal
+	struct FPlaneMoments
+	{
+		float W = 0.f;
+		float X = 0.f, Y = 0.f, Z = 0.f;
+		float XX = 0.f, XY = 0.f, XZ = 0.f, YY = 0.f, YZ = 0.f, ZZ = 0.f;
+		float NX = 0.f, NY = 0.f, NZ = 0.f;
+		int32 NumInliers = 0;
+	};
+
+	void ComputeDistanceWeights(const FVector3f& InReference, float InFalloff, float* OutWeights) const
+	{
+		const float InvFalloffSquared = 1.f / FMath::Max(FMath::Square(InFalloff), UE_KINDA_SMALL_NUMBER);
+
+		const VectorRegister4Float ReferenceX = VectorSetFloat1(InReference.X);
+		const VectorRegister4Float ReferenceY = VectorSetFloat1(InReference.Y);
+		const VectorRegister4Float ReferenceZ = VectorSetFloat1(InReference.Z);
+		const VectorRegister4Float InvFalloff = VectorSetFloat1(InvFalloffSquared);
+
+		int32 Index = 0;
+
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			const VectorRegister4Float DeltaX = VectorSubtract(VectorLoad(PointX + Index), ReferenceX);
+			const VectorRegister4Float DeltaY = VectorSubtract(VectorLoad(PointY + Index), ReferenceY);
+			const VectorRegister4Float DeltaZ = VectorSubtract(VectorLoad(PointZ + Index), ReferenceZ);
+
+			VectorRegister4Float DistanceSquared = VectorMultiply(DeltaX, DeltaX);
+			DistanceSquared = VectorMultiplyAdd(DeltaY, DeltaY, DistanceSquared);
+			DistanceSquared = VectorMultiplyAdd(DeltaZ, DeltaZ, DistanceSquared);
+
+			// 1 / (1 + d^2 / falloff^2)
+			VectorStore(VectorDivide(VectorOneFloat(), VectorMultiplyAdd(DistanceSquared, InvFalloff, VectorOneFloat())), OutWeights + Index);
+		}
+
+		for (; Index < Num; Index++)
+		{
+			const float DistanceSquared = FVector3f::DistSquared(FVector3f(PointX[Index], PointY[Index], PointZ[Index]), InReference);
+			OutWeights[Index] = 1.f / (1.f + DistanceSquared * InvFalloffSquared);
+		}
+	}
+
+	FPlaneMoments AccumulateMoments(const float* InWeights, int32 InNumInliers) const
+	{
+		VectorRegister4Float W = VectorZeroFloat();
+		VectorRegister4Float X = VectorZeroFloat(), Y = VectorZeroFloat(), Z = VectorZeroFloat();
+		VectorRegister4Float XX = VectorZeroFloat(), XY = VectorZeroFloat(), XZ = VectorZeroFloat();
+		VectorRegister4Float YY = VectorZeroFloat(), YZ = VectorZeroFloat(), ZZ = VectorZeroFloat();
+		VectorRegister4Float NX = VectorZeroFloat(), NY = VectorZeroFloat(), NZ = VectorZeroFloat();
+
+		int32 Index = 0;
+
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			const VectorRegister4Float Weight = VectorLoad(InWeights + Index);
+			const VectorRegister4Float PX = VectorLoad(PointX + Index);
+			const VectorRegister4Float PY = VectorLoad(PointY + Index);
+			const VectorRegister4Float PZ = VectorLoad(PointZ + Index);
+
+			const VectorRegister4Float WX = VectorMultiply(Weight, PX);
+			const VectorRegister4Float WY = VectorMultiply(Weight, PY);
+			const VectorRegister4Float WZ = VectorMultiply(Weight, PZ);
+
+			W = VectorAdd(W, Weight);
+			X = VectorAdd(X, WX);
+			Y = VectorAdd(Y, WY);
+			Z = VectorAdd(Z, WZ);
+
+			XX = VectorMultiplyAdd(WX, PX, XX);
+			XY = VectorMultiplyAdd(WX, PY, XY);
+			XZ = VectorMultiplyAdd(WX, PZ, XZ);
+			YY = VectorMultiplyAdd(WY, PY, YY);
+			YZ = VectorMultiplyAdd(WY, PZ, YZ);
+			ZZ = VectorMultiplyAdd(WZ, PZ, ZZ);
+
+			NX = VectorMultiplyAdd(Weight, VectorLoad(NormalX + Index), NX);
+			NY = VectorMultiplyAdd(Weight, VectorLoad(NormalY + Index), NY);
+			NZ = VectorMultiplyAdd(Weight, VectorLoad(NormalZ + Index), NZ);
+		}
+
+		FPlaneMoments Moments;
+		Moments.W = HorizontalSum(W);
+		Moments.X = HorizontalSum(X);
+		Moments.Y = HorizontalSum(Y);
+		Moments.Z = HorizontalSum(Z);
+		Moments.XX = HorizontalSum(XX);
+		Moments.XY = HorizontalSum(XY);
+		Moments.XZ = HorizontalSum(XZ);
+		Moments.YY = HorizontalSum(YY);
+		Moments.YZ = HorizontalSum(YZ);
+		Moments.ZZ = HorizontalSum(ZZ);
+		Moments.NX = HorizontalSum(NX);
+		Moments.NY = HorizontalSum(NY);
+		Moments.NZ = HorizontalSum(NZ);
+		Moments.NumInliers = InNumInliers;
+
+		for (; Index < Num; Index++)
+		{
+			const float Weight = InWeights[Index];
+			const float WX = Weight * PointX[Index];
+			const float WY = Weight * PointY[Index];
+			const float WZ = Weight * PointZ[Index];
+
+			Moments.W += Weight;
+			Moments.X += WX;
+			Moments.Y += WY;
+			Moments.Z += WZ;
+			Moments.XX += WX * PointX[Index];
+			Moments.XY += WX * PointY[Index];
+			Moments.XZ += WX * PointZ[Index];
+			Moments.YY += WY * PointY[Index];
+			Moments.YZ += WY * PointZ[Index];
+			Moments.ZZ += WZ * PointZ[Index];
+			Moments.NX += Weight * NormalX[Index];
+			Moments.NY += Weight * NormalY[Index];
+			Moments.NZ += Weight * NormalZ[Index];
+		}
+
+		return Moments;
+	}
+
+	static bool SolvePlane(const FPlaneMoments& InMoments, const FClimbPlaneFitSettings& InSettings, FVector3f& OutCentroid, FVector3f& OutNormal)
+	{
+		if (InMoments.W <= UE_SMALL_NUMBER) return false;
+
+		const FVector3f WeightedNormal = FVector3f(InMoments.NX, InMoments.NY, InMoments.NZ).GetSafeNormal();
+		if (WeightedNormal.IsZero()) return false;
+
+		const float InvW = 1.f / InMoments.W;
+		OutCentroid = FVector3f(InMoments.X, InMoments.Y, InMoments.Z) * InvW;
+		OutNormal = WeightedNormal;
+
+		if (InMoments.NumInliers < 3) return true;
+
+		// Weighted covariance of the points around the centroid
+		const float CXX = InMoments.XX * InvW - OutCentroid.X * OutCentroid.X;
+		const float CXY = InMoments.XY * InvW - OutCentroid.X * OutCentroid.Y;
+		const float CXZ = InMoments.XZ * InvW - OutCentroid.X * OutCentroid.Z;
+		const float CYY = InMoments.YY * InvW - OutCentroid.Y * OutCentroid.Y;
+		const float CYZ = InMoments.YZ * InvW - OutCentroid.Y * OutCentroid.Z;
+		const float CZZ = InMoments.ZZ * InvW - OutCentroid.Z * OutCentroid.Z;
+
+		auto MultiplyCovariance = [&](const FVector3f& V)
+		{
+			return FVector3f(
+				CXX * V.X + CXY * V.Y + CXZ * V.Z,
+				CXY * V.X + CYY * V.Y + CYZ * V.Z,
+				CXZ * V.X + CYZ * V.Y + CZZ * V.Z);
+		};
+
+		// Power iteration on (trace * I - C) converges on the smallest eigenvector of C, which is the plane normal.
+		// Starting from the weighted normal it only needs a few steps.
+		const float Trace = CXX + CYY + CZZ;
+		FVector3f FittedNormal = WeightedNormal;
+
+		for (int32 Iteration = 0; Iteration < 8; Iteration++)
+		{
+			const FVector3f Next = (FittedNormal * Trace - MultiplyCovariance(FittedNormal)).GetSafeNormal();
+			if (Next.IsZero()) return true;
+
+			FittedNormal = Next;
+		}
+
+		// The points need to spread along both tangents for the fit to mean anything
+		FVector3f TangentA;
+		FVector3f TangentB;
+		FittedNormal.FindBestAxisVectors(TangentA, TangentB);
+
+		const float A = TangentA | MultiplyCovariance(TangentA);
+		const float B = TangentA | MultiplyCovariance(TangentB);
+		const float D = TangentB | MultiplyCovariance(TangentB);
+		const float SmallerTangentSpread = 0.5f * (A + D) - FMath::Sqrt(FMath::Square(0.5f * (A - D)) + B * B);
+
+		if (SmallerTangentSpread < FMath::Square(InSettings.MinSpread)) return true;
+
+		if ((FittedNormal | WeightedNormal) < 0.f)
+		{
+			FittedNormal = -FittedNormal;
+		}
+
+		if ((FittedNormal | WeightedNormal) >= InSettings.MaxFitAngleCos)
+		{
+			OutNormal = FittedNormal;
+		}
+
+		return true;
+	}
+
+	// Zero the weight of every sample too far from the plane or facing away from it, returns how many are left
+	int32 RejectOutliers(const FVector3f& InCentroid, const FVector3f& InNormal, const FClimbPlaneFitSettings& InSettings, float* InOutWeights) const
+	{
+		const VectorRegister4Float CentroidX = VectorSetFloat1(InCentroid.X);
+		const VectorRegister4Float CentroidY = VectorSetFloat1(InCentroid.Y);
+		const VectorRegister4Float CentroidZ = VectorSetFloat1(InCentroid.Z);
+		const VectorRegister4Float PlaneNormalX = VectorSetFloat1(InNormal.X);
+		const VectorRegister4Float PlaneNormalY = VectorSetFloat1(InNormal.Y);
+		const VectorRegister4Float PlaneNormalZ = VectorSetFloat1(InNormal.Z);
+		const VectorRegister4Float MaxDistance = VectorSetFloat1(InSettings.OutlierDistance);
+		const VectorRegister4Float MinCos = VectorSetFloat1(InSettings.OutlierAngleCos);
+
+		int32 NumInliers = 0;
+		int32 Index = 0;
+
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			VectorRegister4Float Distance = VectorMultiply(VectorSubtract(VectorLoad(PointX + Index), CentroidX), PlaneNormalX);
+			Distance = VectorMultiplyAdd(VectorSubtract(VectorLoad(PointY + Index), CentroidY), PlaneNormalY, Distance);
+			Distance = VectorMultiplyAdd(VectorSubtract(VectorLoad(PointZ + Index), CentroidZ), PlaneNormalZ, Distance);
+
+			VectorRegister4Float Cos = VectorMultiply(VectorLoad(NormalX + Index), PlaneNormalX);
+			Cos = VectorMultiplyAdd(VectorLoad(NormalY + Index), PlaneNormalY, Cos);
+			Cos = VectorMultiplyAdd(VectorLoad(NormalZ + Index), PlaneNormalZ, Cos);
+
+			const VectorRegister4Float InlierMask = VectorBitwiseAnd(
+				VectorCompareLE(VectorAbs(Distance), MaxDistance),
+				VectorCompareGE(Cos, MinCos));
+
+			VectorStore(VectorSelect(InlierMask, VectorLoad(InOutWeights + Index), VectorZeroFloat()), InOutWeights + Index);
+			NumInliers += FMath::CountBits(static_cast<uint64>(VectorMaskBits(InlierMask)));
+		}
+
+		for (; Index < Num; Index++)
+		{
+			const FVector3f Point(PointX[Index], PointY[Index], PointZ[Index]);
+			const FVector3f Normal(NormalX[Index], NormalY[Index], NormalZ[Index]);
+
+			const bool bInlier =
+				FMath::Abs((Point - InCentroid) | InNormal) <= InSettings.OutlierDistance &&
+				(Normal | InNormal) >= InSettings.OutlierAngleCos;
+
+			if (bInlier)
+			{
+				NumInliers++;
+			}
+			else
+			{
+				InOutWeights[Index] = 0.f;
+			}
+		}
+
+		return NumInliers;
+	}
+
+	static float HorizontalSum(const VectorRegister4Float& InVector)
+	{
+		alignas(16) float Lanes[4];
+		VectorStoreAligned(InVector, Lanes);
+
+		return (Lanes[0] + Lanes[1]) + (Lanes[2] + Lanes[3]);
+	}
+};
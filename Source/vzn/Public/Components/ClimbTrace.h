@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+
+#if !defined(CLIMB_TRACE_ENABLED)
+#define CLIMB_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+#endif
+
+// Shape of a climb scene query
+namespace EClimbQueryShape
+{
+	enum Type : uint8
+	{
+		Capsule,
+		Line
+	};
+}
+
+// What a climb scene query was issued for
+namespace EClimbQueryPurpose
+{
+	enum Type : uint8
+	{
+		Surface,
+		Floor,
+		Ledge,
+		LedgeWalkable,
+		EyeClimb,
+		EyeHopUp,
+		EyeSafetyLedge,
+		EyeHopDown,
+		ClimbDownWalkable,
+		ClimbDownLedge,
+		Vault,
+		LookAheadFloor,
+		LookAheadLedge,
+		LookAheadLedgeWalkable
+	};
+}
+
+#if CLIMB_TRACE_ENABLED
+
+// Insights channel for the climb scene queries, enable with -trace=default,climb
+UE_TRACE_CHANNEL_EXTERN(ClimbChannel, VZN_API)
+
+struct VZN_API FClimbQueryTrace
+{
+	static void OutputSceneQuery(uint32 InCharacterId, EClimbQueryShape::Type InShape, EClimbQueryPurpose::Type InPurpose, int32 InNumHits, bool bInBakedIndex);
+};
+
+#define TRACE_CLIMB_SCENE_QUERY(CharacterId, Shape, Purpose, NumHits, bBakedIndex) \
+	FClimbQueryTrace::OutputSceneQuery(CharacterId, Shape, Purpose, NumHits, bBakedIndex)
+
+#else
+
+#define TRACE_CLIMB_SCENE_QUERY(CharacterId, Shape, Purpose, NumHits, bBakedIndex)
+
+#endif
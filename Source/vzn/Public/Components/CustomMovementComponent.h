@@ -4,25 +4,54 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Components/ClimbEnvironmentSnapshot.h"
+#include "Components/ClimbSurfaceCache.h"
+#include "Components/ClimbLookAheadTraces.h"
+#include "Components/ClimbTrace.h"
+#include "Components/CharacterMovementSnapshot.h"
+#include "Components/ClimbSavedMove.h"
 #include "CustomMovementComponent.generated.h"
 
 DECLARE_DELEGATE(FOnEnterClimbState)
 DECLARE_DELEGATE(FOnExitClimbState)
+DECLARE_DELEGATE(FOnEnterSlideState)
+DECLARE_DELEGATE(FOnExitSlideState)
+DECLARE_DELEGATE(FOnEnterGrappleState)
+DECLARE_DELEGATE(FOnExitGrappleState)
 
 class UAnimMontage;
 class UAnimInstance;
 class AvznCharacter;
+class UClimbSurfaceIndexSubsystem;
+class UClimbQuerySubsystem;
+struct FClimbBatchedQuery;
+struct FClimbSurfaceIndex;
+struct FClimbHopCell;
 
 UENUM(BlueprintType)
 namespace ECustomMovementMode
 {
 	enum Type
 	{
-		MOVE_Climb UMETA(DisplayName = "Climb Mode")
+		MOVE_Climb UMETA(DisplayName = "Climb Mode"),
+		MOVE_Slide UMETA(DisplayName = "Slide Mode"),
+		MOVE_Grapple UMETA(DisplayName = "Grapple Mode")
 		//MOVE_WallRun UMETA(DisplayName = "Wall Run Mode")
 	};
 }
 
+// Movement LOD while climbing, from most to least significant
+namespace EClimbLOD
+{
+	enum Type : uint8
+	{
+		Full,		// PhysClimb every tick
+		Reduced,	// PhysClimb at ClimbLODReducedInterval, the mesh is interpolated in between
+		Rail,		// No surface traces, sweeps along the last known surface plane
+		Dormant		// No movement at all
+	};
+}
+
 /**
  * 
  */
@@ -30,17 +59,29 @@ UCLASS()
 class VZN_API UCustomMovementComponent : public UCharacterMovementComponent
 {
 	GENERATED_BODY()
+
+	friend class FSavedMove_Climb;
 	
 public:
+	UCustomMovementComponent();
+
 	FOnEnterClimbState OnEnterClimbStateDelegate; // Delegates to be called when the character enters and exits the climbing state
 	FOnExitClimbState OnExitClimbStateDelegate; 
 
+	FOnEnterSlideState OnEnterSlideStateDelegate; // Also called on simulated proxies, when the replicated movement mode changes
+	FOnExitSlideState OnExitSlideStateDelegate;
+
+	FOnEnterGrappleState OnEnterGrappleStateDelegate; // Also called on simulated proxies
+	FOnExitGrappleState OnExitGrappleStateDelegate;
+
 protected:
 
 #pragma region OverridenFunctions
 
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
@@ -54,20 +95,93 @@ protected:
 
 #pragma endregion
 
+#pragma region NetworkPrediction
+
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+
+	virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override; // Act on the climb intents, on the client and again on the server for the same move
+
+	virtual bool ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc, const FVector& RelativeClientLoc, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
+
+	virtual void SimulateMovement(float DeltaTime) override;
+
+	virtual void SmoothClientPosition(float DeltaSeconds) override;
+
+	virtual void OnClientCorrectionReceived(class FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode) override;
+
+#pragma endregion
+
 private:
 
 #pragma region ClimbTraces
 
-	TArray<FHitResult> DoCapsuleTraceMultiByObject(const FVector& Start, const FVector& End, bool bShowDebugShape = false, bool bDrawPersistantShapes = false);
-	FHitResult DoLineTraceSingleByObject(const FVector& Start, const FVector& End, bool bShowDebugShape = false, bool bDrawPersistantShapes = false);
+	// Native traces against the climbable object types, capsule hits are packed into caller owned surface samples
+	bool DoCapsuleTraceMultiByObject(const FVector& Start, const FVector& End, FClimbSurfaceSamples& OutSamples, EClimbQueryPurpose::Type Purpose, bool bShowDebugShape = false, bool bDrawPersistantShapes = false);
+	FHitResult DoLineTraceSingleByObject(const FVector& Start, const FVector& End, EClimbQueryPurpose::Type Purpose, bool bShowDebugShape = false, bool bDrawPersistantShapes = false);
+
+	void RecordSceneQuery(EClimbQueryShape::Type Shape, EClimbQueryPurpose::Type Purpose, int32 NumHits, bool bBakedIndex); // Per frame counters and the Insights event, baked queries didn't touch the physics scene
+
+	void RecordDroppedSurfaceSamples(int32 InNumDropped); // Counts and warns about hits past the surface sample capacity
+
+	void InitClimbTraceParams(); // Build the query params and owner ignore list once, instead of per trace
+
+	const FClimbSurfaceIndex* FindClimbSurfaceIndex(const FBox& InQueryBounds) const; // Baked index covering the query, static geometry is then read from it instead of traced
+
+	void OnLookAheadTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
 
 #pragma	endregion
 
+#pragma region Slide
+
+	bool CanStartSliding() const;
+
+	void StartSliding();
+	void StopSliding();
+
+	void PhysSlide(float deltaTime, int32 Iterations);
+
+	void SetSlideCapsule(bool bSliding); // Shrink or restore the capsule, keeping its bottom where it is
+
+#pragma endregion
+
+#pragma region Grapple
+
+	bool CanStartGrappling() const;
+	bool IsGrappleAnchorValid() const; // Server side check of a client's anchor against the targets and the world
+
+	void StartGrappling();
+	void StopGrappling();
+
+	void PhysGrapple(float deltaTime, int32 Iterations);
+	void PhysGrappleSubstep(float DeltaTime);
+
+#pragma endregion
+
 #pragma region ClimbCore
 
 	bool TraceClimbableSurfaces();
 
-	FHitResult TraceFromEyeHeight(float TraceDistance, float TraceStartOffset = 0.f, bool bShowDebugShape = false, bool bDrawPersistantShapes = false);
+	FHitResult TraceFromEyeHeight(EClimbQueryPurpose::Type Purpose, float TraceDistance, float TraceStartOffset = 0.f, bool bShowDebugShape = false, bool bDrawPersistantShapes = false);
+
+	void ResolveEnvironmentProbes(uint8 InProbes); // Trace any probe groups that haven't been taken yet this frame
+
+	void PublishMovementSnapshot(); // Once per tick, for the anim instance
+
+	bool CanReuseClimbQuery(const FClimbCachedQuery& InQuery); // Check the capsule is still close enough to where the cached traces were taken
+
+	void CaptureClimbQuery(FClimbCachedQuery& InQuery, int32 InNumSceneQueries, TConstArrayView<FHitResult> InHits);
+
+	void IssueLookAheadTraces(float DeltaTime); // Async floor and ledge traces for the next tick, from the predicted capsule location
+
+	bool WillReuseClimbQuery(const FClimbCachedQuery& InQuery, const FVector& InLocation, const FQuat& InQuat) const; // Whether a check run from this transform would take the cached results, without counting it
+
+	bool CanUseLookAheadTrace(bool bPending, const FVector& InPredictedLocation) const;
+
+	bool ConsumeLookAheadSurfaceTrace(); // Fill the surface samples from this frame's batched query, returns false if it has to be traced synchronously
+
+	bool ConsumeLookAheadFloorTrace(); // Fill the floor cache from last tick's async trace, returns false if it has to be traced synchronously
+
+	bool ConsumeLookAheadLedgeTraces();
 
 	bool CanStartClimbing();
 
@@ -77,8 +191,34 @@ private:
 
 	void StopClimbing();
 
+	void ToggleClimbing(bool bEnableClimb); // Start or stop climbing straight away, input goes through RequestClimbToggle so it's predicted
+
+	void HandleHopRequest(); // Hop up or down the wall in the direction of the input
+
 	void PhysClimb(float deltaTime, int32 Iterations);
 
+	void PhysClimbStep(float deltaTime); // One climb integration step, fixed size unless fixed steps are off or root motion is playing
+
+	bool PhysClimbRail(float DeltaTime); // Cheap PhysClimb for the rail LOD, false if it handed this tick back to the full climb
+
+	float UpdateClimbLOD(float DeltaTime); // Pick the LOD for this frame, returns the time to simulate or zero to skip the movement tick
+
+	EClimbLOD::Type EvaluateClimbLOD() const;
+
+	void SetClimbLOD(EClimbLOD::Type InLOD);
+
+	void UpdateClimbLODMeshOffset(float DeltaTime); // Ease the mesh from where the last reduced rate step left it onto the capsule
+
+	void SetClimbMeshOffset(const FVector& InWorldOffset); // Draw the mesh away from the capsule, for interpolating between simulation steps
+
+	void SetClimbMeshTransform(const FVector& InWorldLocation, const FQuat& InWorldQuat); // Draw the mesh as if the capsule was here
+
+	bool IsClimbingSimulatedProxy() const; // Remote climber that's smoothed instead of simulated
+
+	void UpdateClimbProxy(float DeltaTime); // Draw the mesh between replicated positions, turning like GetClimbRotation, no scene queries
+
+	void ResetClimbProxy();
+
 	void ProcessClimableSurfaceInfo();
 
 	bool CheckShouldStopClimbing();
@@ -87,10 +227,14 @@ private:
 
 	FQuat GetClimbRotation(float DeltaTime);
 
-	void SnapMovementToClimableSurfaces(float DeltaTime);
+	FVector GetClimbSnapDelta(float DeltaTime) const; // Pull onto the surface, folded into the step's climb move
+
+	void RecordClimbComponentMove(); // Per frame move counter and stat
 
 	bool CheckHasReachedLedge();
 
+	const FClimbHopCell* FindClimbHopCell() const; // Baked hop and mantle results for the wall point we're climbing on, if the level has them
+
 	void TryStartVaulting(); // Check if the character can vault
 
 	bool CanStartVaulting(FVector& OutVaultStartPosition, FVector& OutVaultEndPosition); // Check if the character can vault
@@ -138,12 +282,94 @@ private:
 
 #pragma region ClimbCoreVariables
 
-	TArray<FHitResult> ClimbableSurfacesTracedResults;
+	FClimbSurfaceSamples ClimbableSurfaceSamples; // Points and normals from the last climbable surfaces trace
+
+	static constexpr int32 ClimbHitBufferReserve = FClimbSurfaceSamples::Capacity; // Every hit the samples can hold, so the hit buffer doesn't grow during play
+
+	TArray<FHitResult> ClimbHitScratch; // Full hits of this component's last capsule trace
+
+	FCollisionObjectQueryParams ClimbObjectQueryParams;
+
+	FCollisionQueryParams ClimbQueryParams;
+
+	FCollisionQueryParams ClimbDynamicQueryParams; // Only movable primitives, for traces where the static geometry comes from the baked index
+
+	UPROPERTY()
+	UClimbSurfaceIndexSubsystem* ClimbIndexSubsystem;
+
+	UPROPERTY()
+	UClimbQuerySubsystem* ClimbQuerySubsystem; // Only set when the queries are batched
+
+	FTraceDelegate LookAheadTraceDelegate;
+
+	uint64 LastBatchedClimbQueryFrame = 0;
+	FVector LastBatchedClimbQueryLocation = FVector::ZeroVector; // Where the results we're living on were taken
+	uint64 ClimbQueryThrottledFrame = 0; // Frame the query batch ran out of budget for us, the cached results are reused within climb.QueryMaxStaleFrames/Distance
+
+	uint32 NumTraceHeapAllocations = 0; // Times a hit buffer had to grow, should stay at zero after the first climb
+
+	uint32 NumDroppedSurfaceSamples = 0; // Hits that didn't fit in the surface samples
+
+	uint64 SceneQueryFrame = 0;
+	uint32 NumSceneQueriesThisFrame = 0; // Scene queries issued by this character in SceneQueryFrame
+
+	uint64 ComponentMoveFrame = 0;
+	uint32 NumComponentMovesThisFrame = 0; // Capsule moves made by the climb in ComponentMoveFrame
+
+	uint64 PhysClimbFrame = 0;
+	double PhysClimbSecondsThisFrame = 0.0; // Time spent in PhysClimb during PhysClimbFrame
+
+	FClimbEnvironmentSnapshot EnvironmentSnapshot; // Shared probes for the climb, ledge, vault and hop predicates
+
+	FClimbSurfaceCache ClimbSurfaceCache; // Traces from previous PhysClimb ticks that are still valid
+
+	FClimbLookAheadTraces LookAheadTraces; // Async ledge and floor traces issued last tick
+
+	FCharacterMovementSnapshot MovementSnapshot; // Only written by PublishMovementSnapshot
 
 	FVector CurrentClimbableSurfaceLocation;
 
+	float ClimbStepAccumulator = 0.f; // Time not yet simulated by the fixed climb steps, saved with every move for replays
+	FVector ClimbPreviousStepLocation = FVector::ZeroVector; // Capsule before the last step, the mesh is drawn between the two
+	FQuat ClimbPreviousStepQuat = FQuat::Identity;
+
+	EClimbLOD::Type ClimbLOD = EClimbLOD::Full;
+	float ClimbLODDowngradeTime = 0.f; // How long a lower LOD has been wanted for
+	float ClimbLODAccumulatedTime = 0.f; // Unsimulated time at the reduced rate
+	FVector ClimbLODMeshOffset = FVector::ZeroVector; // World offset of the mesh from the capsule, decays to zero between reduced rate steps
+	float ClimbLODMeshOffsetAlpha = 0.f;
+	FVector ClimbRailStartLocation = FVector::ZeroVector;
+	float ClimbRailSurfaceDistance = 0.f; // Distance from the surface plane kept while on the rail
+
 	FVector CurrentClimbableSurfaceNormal;
 
+	bool bWantsToClimb = false; // Held states for the next move, sent in the compressed flags
+	bool bWantsToHop = false; // One shot, not replayed
+	bool bWantsToSlide = false;
+	bool bWantsToGrapple = false; // Held, GrappleRequestAnchor goes with it in the move data
+
+	FVector GrappleRequestAnchor = FVector::ZeroVector;
+	FVector GrappleAnchor = FVector::ZeroVector; // Anchor of the current grapple
+	float GrappleRopeLength = 0.f;
+
+	FCharacterNetworkMoveDataContainer_Climb ClimbMoveDataContainer;
+
+	uint32 NumClimbNetCorrections = 0; // Server corrections received while climbing
+
+	uint32 NumServerCorrections = 0; // Corrections sent to the owning client, in any movement mode
+
+	static constexpr float ClimbRotationInterpSpeed = 5.f;
+
+	// Simulated proxy smoothing, the capsule sits at the last replicated position and only the mesh moves in between
+	bool bClimbProxyActive = false;
+	FVector ClimbProxyFromLocation = FVector::ZeroVector; // Where the mesh was drawn when the last update arrived
+	FVector ClimbProxyToLocation = FVector::ZeroVector;
+	FVector ClimbProxyLocation = FVector::ZeroVector; // Drawn this frame
+	FQuat ClimbProxyQuat = FQuat::Identity;
+	float ClimbProxyAlpha = 1.f;
+	float ClimbProxyUpdateInterval = 0.1f; // Measured between the last two updates
+	double ClimbProxyLastUpdateTime = 0.0;
+
 	UPROPERTY()
 	UAnimInstance* OwningPlayerAnimInstance;
 
@@ -158,6 +384,10 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true"))
 	TArray < TEnumAsByte<EObjectTypeQuery> > ClimbableSurfaceTraceTypes;
 
+	// Only trace the simplified climb proxies (ECC_Climb) instead of the ClimbableSurfaceTraceTypes, needs UClimbProxyComponent on the climbable actors
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true"))
+	bool bTraceClimbProxiesOnly = false;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true"))
 	float CapsuleTraceRadius = 50.f;
 
@@ -179,6 +409,93 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true"))
 	float ClimbDownLedgeTraceOffset = 50.f;
 
+	// Fit a plane through the surface hits instead of averaging them, keeps the climb rotation steady on faceted walls
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true"))
+	bool bUseClimbSurfacePlaneFit = true;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true", EditCondition = "bUseClimbSurfacePlaneFit"))
+	float PlaneFitWeightFalloff = 50.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true", EditCondition = "bUseClimbSurfacePlaneFit"))
+	float PlaneFitOutlierDistance = 10.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true", EditCondition = "bUseClimbSurfacePlaneFit"))
+	float PlaneFitOutlierAngle = 30.f;
+
+	// Skip re-tracing while climbing if the capsule has moved less than these since the last trace
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true"))
+	bool bEnableClimbTraceCache = true;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true", EditCondition = "bEnableClimbTraceCache"))
+	float ClimbTraceCacheMaxDistance = 2.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true", EditCondition = "bEnableClimbTraceCache"))
+	float ClimbTraceCacheMaxAngle = 1.f;
+
+	// Issue the ledge and floor checks as async traces one tick ahead, synchronous traces are used when the prediction is off
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true"))
+	bool bUseAsyncLookAheadTraces = true;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true", EditCondition = "bUseAsyncLookAheadTraces"))
+	float LookAheadMaxDistanceError = 5.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true", EditCondition = "bUseAsyncLookAheadTraces"))
+	float LookAheadMaxAngleError = 2.f;
+
+	// Run the surface, floor and ledge traces in the world's parallel climb query batch before the tick, instead of async look-ahead traces
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true"))
+	bool bUseBatchedClimbQueries = true;
+
+	// Integrate the climb in fixed size steps so the snap and rotation behave the same at any frame rate, the mesh is interpolated between steps
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true"))
+	bool bUseFixedClimbStep = true;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true", EditCondition = "bUseFixedClimbStep", ClampMin = "0.001"))
+	float FixedClimbStepSize = 1.f / 60.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true", EditCondition = "bUseFixedClimbStep", ClampMin = "1"))
+	int32 MaxClimbSubsteps = 8;
+
+	// Drop climbers that are far away or off screen to cheaper movement, players and root motion always get the full simulation
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing|LOD", meta = (AllowPrivateAccess = "true"))
+	bool bEnableClimbLOD = true;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing|LOD", meta = (AllowPrivateAccess = "true", EditCondition = "bEnableClimbLOD"))
+	float ClimbLODReducedDistance = 2000.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing|LOD", meta = (AllowPrivateAccess = "true", EditCondition = "bEnableClimbLOD"))
+	float ClimbLODRailDistance = 5000.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing|LOD", meta = (AllowPrivateAccess = "true", EditCondition = "bEnableClimbLOD"))
+	float ClimbLODDormantDistance = 15000.f;
+
+	// Off screen climbers count as this much further away, only where the views are rendered (standalone and clients)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing|LOD", meta = (AllowPrivateAccess = "true", EditCondition = "bEnableClimbLOD"))
+	float ClimbLODOffScreenDistanceScale = 3.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing|LOD", meta = (AllowPrivateAccess = "true", EditCondition = "bEnableClimbLOD"))
+	float ClimbLODReducedInterval = 0.1f;
+
+	// A lower LOD has to be wanted this long before switching, a higher one is switched to straight away
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing|LOD", meta = (AllowPrivateAccess = "true", EditCondition = "bEnableClimbLOD"))
+	float ClimbLODDowngradeDelay = 0.5f;
+
+	// How far the rail can carry a climber from the last traced point before handing back to the full climb to be traced again
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing|LOD", meta = (AllowPrivateAccess = "true", EditCondition = "bEnableClimbLOD"))
+	float ClimbLODRailMaxTravel = 150.f;
+
+	// Longest gap between updates a remote climber is interpolated over, anything slower is drawn at this rate
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing|Networking", meta = (AllowPrivateAccess = "true", ClampMin = "0.01"))
+	float ClimbProxyMaxUpdateInterval = 0.25f;
+
+	// Saved climbing moves only combine while the surface normal turns less than this
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing|Networking", meta = (AllowPrivateAccess = "true"))
+	float ClimbMoveCombineMaxAngle = 2.f;
+
+	// Answer the climb traces from the level's baked climb index where there is one, only movable geometry is traced live
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true"))
+	bool bUseBakedClimbIndex = true;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (AllowPrivateAccess = "true"))
 	UAnimMontage* IdleToClimbMontage;
 
@@ -199,13 +516,118 @@ private:
 
 #pragma endregion
 
+#pragma region SlideBPVariables
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Sliding", meta = (AllowPrivateAccess = "true"))
+	float SlideInitialSpeed = 1500.f; // Speed the slide starts at, and the most it can build up going downhill
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Sliding", meta = (AllowPrivateAccess = "true"))
+	float SlideDeceleration = 500.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Sliding", meta = (AllowPrivateAccess = "true"))
+	float MinSlideSpeed = 500.f; // The slide ends below this
+
+	// How much of gravity along the floor is added to the slide, speeding it up downhill and slowing it uphill
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Sliding", meta = (AllowPrivateAccess = "true"))
+	float SlideGravityScale = 1.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Sliding", meta = (AllowPrivateAccess = "true"))
+	float SlideCapsuleHalfHeight = 48.f;
+
+#pragma endregion
+
+#pragma region GrappleBPVariables
+
+	// Longest rope, the server won't start a grapple to an anchor further than this. The interact sweep reach plus its radius
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Grappling", meta = (AllowPrivateAccess = "true"))
+	float GrappleMaxLength = 1100.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Grappling", meta = (AllowPrivateAccess = "true"))
+	float GrappleMinLength = 150.f;
+
+	// How far a client's anchor can be from a grapple target, or from where the server's own trace hits, and still be accepted
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Grappling", meta = (AllowPrivateAccess = "true"))
+	float GrappleAnchorTolerance = 50.f;
+
+	// Rope reeled in per second with no input, negative to pay it out
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Grappling", meta = (AllowPrivateAccess = "true"))
+	float GrappleReelSpeed = 300.f;
+
+	// Extra reel speed from full input towards the anchor, or away from it to pay out
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Grappling", meta = (AllowPrivateAccess = "true"))
+	float GrappleReelInputSpeed = 500.f;
+
+	// Acceleration from full input across the rope, to pump the swing
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Grappling", meta = (AllowPrivateAccess = "true"))
+	float GrappleSwingAcceleration = 800.f;
+
+	// Every grapple move is split into equal substeps no longer than this, so the swing is the same at any frame rate
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Grappling", meta = (AllowPrivateAccess = "true", ClampMin = "0.001"))
+	float MaxGrappleSubstepSize = 1.f / 120.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Grappling", meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 MaxGrappleSubsteps = 16;
+
+#pragma endregion
+
 public: 
 
-	void ToggleClimbing(bool bEnableClimb); // Toggle climbing
-	void RequestHopping(); // Check if the character can hop up or down the wall
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+	virtual void SmoothCorrection(const FVector& OldLocation, const FQuat& OldRotation, const FVector& NewLocation, const FQuat& NewRotation) override;
+
+	void RequestClimbToggle(); // Start or stop climbing on the next move
+	void RequestHopping(); // Hop up or down the wall on the next move, if there's room
 	bool IsClimbing() const;
 
+	void SetWantsToSlide(bool bInWantsToSlide); // Slide while held, if moving fast enough on the ground
+	bool IsSliding() const;
+
+	virtual bool IsMovingOnGround() const override; // Sliding counts, so it can jump, ride bases and step down slopes like walking
+
+	void RequestGrapple(const FVector& InAnchor); // Swing from the anchor while held, the server checks it's in reach
+	void StopGrapple();
+	bool IsGrappling() const;
+
+	FVector GetGrappleAnchor() const; // Replicated anchor on simulated proxies
+	float GetGrappleRopeLength() const; // Zero on simulated proxies, which don't know it, so their rope is drawn taut
+
 	FORCEINLINE FVector GetClimbableSurfaceNormal() const { return CurrentClimbableSurfaceNormal; } // Get the normal of the climbable surface
 
 	FVector GetUnrotatedClimbVelocity() const;
+
+	FORCEINLINE const FCharacterMovementSnapshot& GetMovementSnapshot() const { return MovementSnapshot; } // State as of the end of the last movement tick
+
+	// Hop and mantle availability from the baked table, cheap enough for per-frame UI hints. False when there's no baked data here
+	bool GetClimbHopHints(bool& bOutCanHopUp, bool& bOutCanHopDown, bool& bOutCanMantle) const;
+
+	// Climb trace cache counters
+	FORCEINLINE uint32 GetClimbTraceCacheHits() const { return ClimbSurfaceCache.NumHits; }
+	FORCEINLINE uint32 GetClimbTraceCacheMisses() const { return ClimbSurfaceCache.NumMisses; }
+	FORCEINLINE uint32 GetClimbTraceCacheSavedQueries() const { return ClimbSurfaceCache.NumSavedSceneQueries; }
+
+	FORCEINLINE uint32 GetClimbTraceHeapAllocations() const { return NumTraceHeapAllocations; }
+
+	FORCEINLINE uint32 GetClimbDroppedSurfaceSamples() const { return NumDroppedSurfaceSamples; }
+
+	FORCEINLINE uint32 GetClimbSceneQueriesThisFrame() const { return SceneQueryFrame == GFrameCounter ? NumSceneQueriesThisFrame : 0; }
+
+	FORCEINLINE uint32 GetClimbComponentMovesThisFrame() const { return ComponentMoveFrame == GFrameCounter ? NumComponentMovesThisFrame : 0; }
+
+	FORCEINLINE double GetPhysClimbSecondsThisFrame() const { return PhysClimbFrame == GFrameCounter ? PhysClimbSecondsThisFrame : 0.0; }
+
+	FORCEINLINE EClimbLOD::Type GetClimbLOD() const { return ClimbLOD; }
+
+	FORCEINLINE uint32 GetClimbNetCorrections() const { return NumClimbNetCorrections; }
+
+	FORCEINLINE uint32 GetServerCorrections() const { return NumServerCorrections; }
+
+	// Called by UClimbQuerySubsystem before the actors tick
+	bool PrepareBatchedClimbQuery(FClimbBatchedQuery& OutQuery, float DeltaTime); // False if we don't need the batch this frame
+	void ApplyBatchedClimbQuery(const FClimbBatchedQuery& InQuery);
+	void ThrottleClimbQueries();
+
+	// Async look-ahead counters
+	FORCEINLINE uint32 GetLookAheadPredictionsUsed() const { return LookAheadTraces.NumPredictionsUsed; }
+	FORCEINLINE uint32 GetLookAheadPredictionFallbacks() const { return LookAheadTraces.NumPredictionFallbacks; }
 };
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SplineMeshComponent.h"
+#include "GrappleRopeComponent.generated.h"
+
+/**
+ * Grapple rope drawn as one spline mesh from the rope start to the anchor, curved by the slack of the movement
+ * component's rope instead of simulated. Sits at the anchor in world space, so the character moving doesn't touch it,
+ * and only ticks and renders while the rope is active.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class VZN_API UGrappleRopeComponent : public USplineMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	UGrappleRopeComponent();
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	void SetRopeActive(bool bActive);
+
+	FORCEINLINE void SetRopeStart(USceneComponent* InRopeStart) { RopeStart = InRopeStart; }
+
+protected:
+
+	virtual void BeginPlay() override;
+
+private:
+
+	void UpdateRope();
+
+	UPROPERTY(EditAnywhere, Category = "Grapple Rope", meta = (ClampMin = "0.1"))
+	float RopeRadius = 1.5f;
+
+	// Applied to the rope mesh in BeginPlay, the same material the cable component used
+	UPROPERTY(EditAnywhere, Category = "Grapple Rope")
+	TObjectPtr<UMaterialInterface> RopeMaterial;
+
+	// Sag of a fully slack rope is capped at this, so a long slack rope doesn't hang through the floor
+	UPROPERTY(EditAnywhere, Category = "Grapple Rope")
+	float MaxRopeSag = 300.f;
+
+	UPROPERTY()
+	TObjectPtr<USceneComponent> RopeStart; // The owner's location when not set
+};
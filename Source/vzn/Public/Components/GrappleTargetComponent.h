@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "GrappleTargetComponent.generated.h"
+
+UENUM()
+namespace EGrappleTargetType
+{
+	enum Type
+	{
+		Anchor UMETA(DisplayName = "Grapple Anchor"),
+		Interactable UMETA(DisplayName = "Interactable")
+	};
+}
+
+/**
+ * Point the player can grapple to or interact with, found by aiming at it.
+ * Registers with UGrappleTargetSubsystem while playing, movable targets move between its cells as they move.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class VZN_API UGrappleTargetComponent : public USceneComponent
+{
+	GENERATED_BODY()
+
+	friend class UGrappleTargetSubsystem;
+
+public:
+	UGrappleTargetComponent();
+
+	FORCEINLINE EGrappleTargetType::Type GetTargetType() const { return TargetType; }
+	FORCEINLINE void SetTargetType(EGrappleTargetType::Type InTargetType) { TargetType = InTargetType; }
+
+	void SetHighlighted(bool bInHighlighted); // Custom depth on the owner's primitives, for the outline post process
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport = ETeleportType::None) override;
+
+private:
+
+	UPROPERTY(EditAnywhere, Category = "Grapple Target")
+	TEnumAsByte<EGrappleTargetType::Type> TargetType = EGrappleTargetType::Anchor;
+
+	bool bHighlighted = false;
+
+	// Cell the subsystem has us in
+	bool bRegistered = false;
+	FIntVector RegisteredCell = FIntVector::ZeroValue;
+};
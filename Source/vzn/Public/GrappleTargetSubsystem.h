@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Components/GrappleTargetComponent.h"
+#include "GrappleTargetSubsystem.generated.h"
+
+// Cone to look for targets in, from the player's aim
+struct FGrappleTargetQuery
+{
+	FVector Origin = FVector::ZeroVector;
+	FVector Direction = FVector::ForwardVector; // Normalized
+
+	float MaxDistance = 1000.f;
+	float ConeHalfAngle = 10.f; // Degrees, below 90
+
+	uint8 TypeMask = 0xFF; // Bits of EGrappleTargetType to accept
+
+	const AActor* IgnoreActor = nullptr; // The player, ignored by the visibility ray as well
+};
+
+/**
+ * Spatial hash of the grapple anchors and interactables in the world. Finding the target in front of the player is
+ * a walk over the cells the aim cone covers and one visibility ray to the best candidate, cheap enough for every frame.
+ */
+UCLASS()
+class VZN_API UGrappleTargetSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	void RegisterTarget(UGrappleTargetComponent* InTarget);
+	void UnregisterTarget(UGrappleTargetComponent* InTarget);
+	void UpdateTarget(UGrappleTargetComponent* InTarget); // After it moved, changes its cell if needed
+
+	// Target closest to the centre of the cone that the origin can see, null if there is none
+	UGrappleTargetComponent* FindTarget(const FGrappleTargetQuery& InQuery) const;
+
+	// Any target within the radius of the location, for checking a point a client says it aimed at
+	UGrappleTargetComponent* FindTargetNear(const FVector& InLocation, float InRadius, uint8 InTypeMask = 0xFF) const;
+
+	FORCEINLINE int32 GetNumTargets() const { return NumTargets; }
+
+private:
+
+	FIntVector GetCell(const FVector& InLocation) const;
+
+	void AddToCell(UGrappleTargetComponent* InTarget, const FIntVector& InCell);
+	void RemoveFromCell(UGrappleTargetComponent* InTarget, const FIntVector& InCell);
+
+	bool IsTargetVisible(const FGrappleTargetQuery& InQuery, const UGrappleTargetComponent* InTarget) const;
+
+	static constexpr float CellSize = 500.f; // Half the grapple reach, so a query covers only a few cells
+
+	static constexpr int32 MaxVisibilityChecks = 4; // Candidates tried in score order before giving up
+
+	// Targets unregister in EndPlay, so the cells never hold a destroyed component
+	TMap<FIntVector, TArray<UGrappleTargetComponent*>> Cells;
+
+	int32 NumTargets = 0;
+};
@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera/CameraModifier.h"
+#include "HeadBobCameraModifier.generated.h"
+
+/**
+ * First person head bob while moving on the ground. Offsets only the final view of the local player's camera manager,
+ * so no component is moved and other players' characters never run it.
+ */
+UCLASS()
+class VZN_API UHeadBobCameraModifier : public UCameraModifier
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ModifyCamera(float DeltaTime, struct FMinimalViewInfo& InOutPOV) override;
+
+private:
+
+	UPROPERTY(EditAnywhere, Category = "Head Bob")
+	float BobbingSpeed = .5f; // How fast the camera bobs
+
+	UPROPERTY(EditAnywhere, Category = "Head Bob")
+	float BobbingAmount = 10.f; // How much the camera bobs
+
+	float BobOffset = 0.f; // Eases back to zero when the character stops
+};
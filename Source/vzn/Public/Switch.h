@@ -32,4 +32,5 @@ public:
 private: 
 	UPROPERTY(EditDefaultsOnly, Category = "Components") class UBoxComponent* BoxCollider;
 	UPROPERTY(EditDefaultsOnly, Category = "Components") class UStaticMeshComponent* SwitchMesh;
+	UPROPERTY(EditDefaultsOnly, Category = "Components") class UGrappleTargetComponent* InteractTarget; // Lets the player aim at the switch
 };
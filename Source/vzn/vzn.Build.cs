@@ -8,6 +8,6 @@ public class vzn : ModuleRules
 	{
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
-		PublicDependencyModuleNames.AddRange(new string[] { "CableComponent",  "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput", "MotionWarping" });
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput", "MotionWarping", "PhysicsCore", "TraceLog", "Json" });
 	}
 }
@@ -13,10 +13,15 @@
 #include "InputActionValue.h"
 #include "DebugHelper.h"
 #include "MotionWarpingComponent.h"
-#include "CableComponent.h"
+#include "Components/GrappleRopeComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Switch.h"
 #include "MovingPlatform.h"
+#include "Benchmark/BotLoadTestComponent.h"
+#include "GrappleTargetSubsystem.h"
+#include "HeadBobCameraModifier.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Net/UnrealNetwork.h"
 
 DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 
@@ -76,21 +81,32 @@ AvznCharacter::AvznCharacter(const FObjectInitializer& ObjectInitializer)
 
 	MotionWarpingComponent = CreateDefaultSubobject<UMotionWarpingComponent>(TEXT("MotionWarpingComp"));
 
-	// Bobbing for first person camera
-	bIsBobbing = false;
-	if (FirstPersonCamera)
-	{
-		DefaultZ = FirstPersonCamera->GetRelativeLocation().Z;
-	}
-
-	GrappleCable = CreateDefaultSubobject<UCableComponent>(TEXT("Grappling Line"));
-	GrappleCable->SetupAttachment(FirstPersonCamera);
-	GrappleCable->SetVisibility(false);
+	// Attached to the root for ownership only, it stays at the anchor in world space and draws back to the camera
+	GrappleRope = CreateDefaultSubobject<UGrappleRopeComponent>(TEXT("Grapple Rope"));
+	GrappleRope->SetupAttachment(RootComponent);
+	GrappleRope->SetRopeStart(FirstPersonCamera);
 
 	// Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character) 
 	// are set in the derived blueprint asset named ThirdPersonCharacter (to avoid direct content references in C++)
 }
 
+void AvznCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// The owner traces for its own surface
+	DOREPLIFETIME_CONDITION(AvznCharacter, ReplicatedClimbSurfaceNormal, COND_SimulatedOnly);
+	DOREPLIFETIME_CONDITION(AvznCharacter, ReplicatedGrappleAnchor, COND_SimulatedOnly);
+}
+
+void AvznCharacter::SetReplicatedClimbSurfaceNormal(const FVector& InNormal)
+{
+	// Plane fit noise would otherwise resend it every update
+	if (InNormal.Equals(ReplicatedClimbSurfaceNormal, 0.01f)) return;
+
+	ReplicatedClimbSurfaceNormal = InNormal;
+}
+
 void AvznCharacter::BeginPlay()
 {
 	// Call the base class  
@@ -106,11 +122,32 @@ void AvznCharacter::BeginPlay()
 	{
 		CustomMovementComponent->OnEnterClimbStateDelegate.BindUObject(this, &ThisClass::OnPlayerEnterClimbState);
 		CustomMovementComponent->OnExitClimbStateDelegate.BindUObject(this, &ThisClass::OnPlayerExitClimbState);
+		CustomMovementComponent->OnEnterSlideStateDelegate.BindUObject(this, &ThisClass::OnPlayerEnterSlideState);
+		CustomMovementComponent->OnExitSlideStateDelegate.BindUObject(this, &ThisClass::OnPlayerExitSlideState);
+		CustomMovementComponent->OnEnterGrappleStateDelegate.BindUObject(this, &ThisClass::OnPlayerEnterGrappleState);
+		CustomMovementComponent->OnExitGrappleStateDelegate.BindUObject(this, &ThisClass::OnPlayerExitGrappleState);
 	}
 
 	//Debug::Print(TEXT("Debug working"));
 }
 
+// Called on the machine of the player controlling us, the per-frame aim and camera work only happens here
+void AvznCharacter::PawnClientRestart()
+{
+	Super::PawnClientRestart();
+
+	// Head bob offsets the final view instead of moving the camera component
+	if (APlayerController* PlayerController = Cast<APlayerController>(Controller))
+	{
+		APlayerCameraManager* CameraManager = PlayerController->PlayerCameraManager;
+
+		if (CameraManager && !CameraManager->FindCameraModifierByClass(UHeadBobCameraModifier::StaticClass()))
+		{
+			CameraManager->AddNewCameraModifier(UHeadBobCameraModifier::StaticClass());
+		}
+	}
+}
+
 void AvznCharacter::AddInputMappingContext(UInputMappingContext* ContextToAdd, int32 InPriority)
 {
 	if (!ContextToAdd) return;
@@ -142,53 +179,10 @@ void AvznCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	// Set the new location of the camera for the bobbing effect
-	FVector CurrentLocation = FirstPersonCamera->GetRelativeLocation();
-
-	// No bobbing effect when standing still
-	float TargetZ = DefaultZ;
-
-	// When the player is moving, turn the bobbing effect on and calculate the new Z location
-	if (GetVelocity().SizeSquared() > 0 && GetCharacterMovement()->IsMovingOnGround())
-	{
-		bIsBobbing = true;
-		float Time = GetWorld()->GetTimeSeconds();
-		// Calculate target Z with bobbing using a sine wave
-		TargetZ += FMath::Sin(Time * BobbingSpeed) * BobbingAmount;
-	}
-	else
-	{
-		bIsBobbing = false;
-	}
-
-	// Camera smoothly transitions from standing still to movement using lerp
-	float NewZ = FMath::Lerp(CurrentLocation.Z, TargetZ, DeltaTime * BobbingSpeed);
-	FirstPersonCamera->SetRelativeLocation(FVector(CurrentLocation.X, CurrentLocation.Y, NewZ));
-
-	if (bIsGrappling)
+	// Every character ticks for Blueprint ReceiveTick, only the local player's highlights its aim target
+	if (IsLocallyControlled())
 	{
-		GrappleCable->EndLocation = GetActorTransform().InverseTransformPosition(GrapplingPoint);
-
-		GetCharacterMovement()->AddForce((GrapplingPoint - GetActorLocation()).GetSafeNormal() * 200000);
-	}
-
-	// Slide
-	if (bIsSliding)
-	{
-		FVector CurrentVelocity = GetVelocity();
-		float Speed = CurrentVelocity.Size();
-		float SpeedReduction = SlideDeceleration * DeltaTime;
-		Speed = FMath::Max(0.f, Speed - SpeedReduction);
-
-		if (Speed > MinSlideSpeed)
-		{
-			CurrentVelocity = CurrentVelocity.GetSafeNormal() * Speed;
-			GetCharacterMovement()->Velocity = CurrentVelocity;
-		}
-		else
-		{
-			OnCrouchEnded(FInputActionValue());
-		}
+		UpdateAimTarget();
 	}
 }
 
@@ -303,15 +297,99 @@ void AvznCharacter::OnClimbActionStarted(const FInputActionValue& Value)
 {
 	if (!CustomMovementComponent) return;
 
-	// Toggle climbing
-	if (!CustomMovementComponent->IsClimbing())
+	// Toggle climbing, on the next move so the server sees it too
+	CustomMovementComponent->RequestClimbToggle();
+}
+
+void AvznCharacter::ScriptedMove(const FVector2D& InMovement)
+{
+	if (CustomMovementComponent && CustomMovementComponent->IsClimbing())
+	{
+		HandleClimbMovementInput(FInputActionValue(InMovement));
+	}
+	else if (Controller != nullptr)
+	{
+		HandleGroundMovementInput(FInputActionValue(InMovement));
+	}
+	else
+	{
+		// No controller to take the yaw from, move relative to where the character is facing
+		AddMovementInput(GetActorForwardVector(), InMovement.Y);
+		AddMovementInput(GetActorRightVector(), InMovement.X);
+	}
+}
+
+void AvznCharacter::ScriptedClimb()
+{
+	OnClimbActionStarted(FInputActionValue());
+}
+
+void AvznCharacter::ScriptedHop()
+{
+	OnClimbHopActionStarted(FInputActionValue());
+}
+
+void AvznCharacter::ScriptedCrouch(bool bPressed)
+{
+	if (bPressed)
+	{
+		OnCrouchStarted(FInputActionValue());
+	}
+	else
+	{
+		OnCrouchEnded(FInputActionValue());
+	}
+}
+
+void AvznCharacter::ScriptedInteract(bool bPressed)
+{
+	if (bPressed)
+	{
+		Interact();
+	}
+	else
+	{
+		StopInteract();
+	}
+}
+
+void AvznCharacter::ScriptedJump(bool bPressed)
+{
+	if (bPressed)
 	{
-		CustomMovementComponent->ToggleClimbing(true);
+		Jump();
 	}
 	else
 	{
-		CustomMovementComponent->ToggleClimbing(false);
+		StopJumping();
+	}
+}
+
+void AvznCharacter::ScriptedReset(const FTransform& InStartTransform)
+{
+	if (!HasAuthority())
+	{
+		// Lanes run along +X, face down it straight away, the teleport itself comes back from the server
+		if (Controller)
+		{
+			Controller->SetControlRotation(FRotator::ZeroRotator);
+		}
+
+		// Only bot load test servers add the component
+		if (UBotLoadTestComponent* BotLoadTest = FindComponentByClass<UBotLoadTestComponent>())
+		{
+			BotLoadTest->ServerResetBot();
+		}
+		return;
+	}
+
+	if (CustomMovementComponent)
+	{
+		CustomMovementComponent->StopMovementImmediately();
+		CustomMovementComponent->SetMovementMode(MOVE_Walking);
 	}
+
+	SetActorTransform(InStartTransform, false, nullptr, ETeleportType::TeleportPhysics);
 }
 
 // Player enters and exits the climb state, adding and removing the climb context
@@ -394,76 +472,134 @@ void AvznCharacter::OnWalkEnded(const FInputActionValue& Value)
 // Crouch / Slide, when the player is moving at a certain speed they will slide and keep some of their speed, if they slow down they stop sliding
 void AvznCharacter::OnCrouchStarted(const FInputActionValue& Value)
 {
-	if (!bIsCrouching && GetCharacterMovement()->IsMovingOnGround() && GetVelocity().Size() >= GetCharacterMovement()->MaxWalkSpeed)
-	{
-		bIsCrouching = true;
-		bIsSliding = true;
-		GetCapsuleComponent()->SetCapsuleHalfHeight(48.f, true);
-		GetCharacterMovement()->GroundFriction = 0; // No friction when sliding to keep speed
-		FVector SlideDirection = GetVelocity().GetSafeNormal();
-		GetCharacterMovement()->Velocity = SlideDirection * SlideInitialSpeed;
-
-		GetMesh()->SetMaterial(0, CrouchingMaterial); // Change material when sliding, lack of animation
-	}
-	else if (bIsCrouching)
+	if (CustomMovementComponent)
 	{
-		OnCrouchEnded(Value);
+		CustomMovementComponent->SetWantsToSlide(true); // The movement component checks the speed and runs the slide
 	}
 }
 
 void AvznCharacter::OnCrouchEnded(const FInputActionValue& Value)
 {
-	if (bIsCrouching)
+	if (CustomMovementComponent)
 	{
-		bIsCrouching = false;
-		bIsSliding = false;
-		GetCapsuleComponent()->SetCapsuleHalfHeight(96.f, true);
-		GetCharacterMovement()->GroundFriction = 8.0;
-		GetCharacterMovement()->BrakingDecelerationWalking = 2048.f;
-
-	    GetMesh()->SetMaterial(0, DefaultMaterial);
-		
+		CustomMovementComponent->SetWantsToSlide(false);
 	}
 }
 
+// Called on every machine when the slide movement mode starts and ends
+void AvznCharacter::OnPlayerEnterSlideState()
+{
+	bIsCrouching = true;
+	bIsSliding = true;
+
+	GetMesh()->SetMaterial(0, CrouchingMaterial); // Change material when sliding, lack of animation
+}
+
+void AvznCharacter::OnPlayerExitSlideState()
+{
+	bIsCrouching = false;
+	bIsSliding = false;
+
+	GetMesh()->SetMaterial(0, DefaultMaterial);
+}
+
 // Interact / Grapple, able to use switches to move platforms and grapple to move around the level
 void AvznCharacter::Interact()
 {
-	FVector Start = GetCapsuleComponent()->GetComponentLocation();
-	FVector End = Start + (MaxLineDistance * UKismetMathLibrary::GetForwardVector 
-	   (FirstPersonCamera->GetComponentRotation()));
-	DrawDebugLine(GetWorld(), Start, End, FColor::Cyan);
-
-	FHitResult HitResult;
-	bool hasHit = GetWorld()->SweepSingleByChannel(HitResult, Start, End, FQuat::Identity, ECC_GameTraceChannel1,
-		FCollisionShape::MakeSphere(100.f)); // ECC_GameTraceChannel1 is the custom channel for Interactables
+	UGrappleTargetComponent* Target = FindAimTarget();
+	if (!Target)
+	{
+		InteractWithSweep();
+		return;
+	}
 
-	// Firstly check for the switch object and activate it also grapple
-	if (hasHit)
+	// Switches are activated, only anchors can be grappled to
+	if (Target->GetTargetType() == EGrappleTargetType::Interactable)
 	{
-		ASwitch* HitActor = Cast<ASwitch>(HitResult.GetActor());
-		if (HitActor != nullptr)
-		{
-			HitActor->OnActivate();
-		}
-		else
+		if (ASwitch* Switch = Cast<ASwitch>(Target->GetOwner()))
 		{
-			bIsGrappling = true;
+			Switch->OnActivate();
 		}
-		bIsGrappling = true;
-		GetCharacterMovement()->SetMovementMode(EMovementMode::MOVE_Flying);
-		GrappleCable->SetVisibility(true);
-		GrapplingPoint = HitResult.ImpactPoint;
 	}
+	else if (CustomMovementComponent)
+	{
+		CustomMovementComponent->RequestGrapple(Target->GetComponentLocation()); // Swings from the next move, on the server too
+	}
+}
+
+// Fallback for switches and grapple points without a target component, the original sweep on the Interactables channel
+void AvznCharacter::InteractWithSweep()
+{
+	const FVector Start = GetCapsuleComponent()->GetComponentLocation();
+	const FVector End = Start + FirstPersonCamera->GetForwardVector() * MaxLineDistance;
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(InteractSweep), false, this);
+
+	FHitResult HitResult;
+	if (!GetWorld()->SweepSingleByChannel(HitResult, Start, End, FQuat::Identity, ECC_GameTraceChannel1, FCollisionShape::MakeSphere(100.f), Params)) return;
+
+	// Same as a registered target, switches are activated rather than grappled to
+	if (ASwitch* Switch = Cast<ASwitch>(HitResult.GetActor()))
+	{
+		Switch->OnActivate();
+	}
+	else if (CustomMovementComponent)
+	{
+		CustomMovementComponent->RequestGrapple(HitResult.ImpactPoint);
+	}
+}
+
+// Registered targets in a cone around the camera's aim, instead of sweeping the scene
+UGrappleTargetComponent* AvznCharacter::FindAimTarget() const
+{
+	const UGrappleTargetSubsystem* TargetSubsystem = GetWorld()->GetSubsystem<UGrappleTargetSubsystem>();
+	if (!TargetSubsystem || !FirstPersonCamera) return nullptr;
+
+	FGrappleTargetQuery Query;
+	Query.Origin = GetCapsuleComponent()->GetComponentLocation();
+	Query.Direction = FirstPersonCamera->GetForwardVector();
+	Query.MaxDistance = MaxLineDistance;
+	Query.ConeHalfAngle = AimConeHalfAngle;
+	Query.IgnoreActor = this;
+
+	return TargetSubsystem->FindTarget(Query);
+}
+
+// Highlights what Interact would use, every frame for the local player
+void AvznCharacter::UpdateAimTarget()
+{
+	UGrappleTargetComponent* NewAimTarget = FindAimTarget();
+	if (NewAimTarget == AimTarget.Get()) return;
+
+	if (UGrappleTargetComponent* OldAimTarget = AimTarget.Get())
+	{
+		OldAimTarget->SetHighlighted(false);
+	}
+
+	if (NewAimTarget)
+	{
+		NewAimTarget->SetHighlighted(true);
+	}
+
+	AimTarget = NewAimTarget;
 }
 
 // Stop grappling, player falls
 void AvznCharacter::StopInteract()
 {
-	bIsGrappling = false;
-	if (!GetCharacterMovement()->IsFalling())
+	if (CustomMovementComponent)
 	{
-		GetCharacterMovement()->SetMovementMode(EMovementMode::MOVE_Falling);
+		CustomMovementComponent->StopGrapple();
 	}
-	GrappleCable->SetVisibility(false);
+}
+
+// Called on every machine when the grapple movement mode starts and ends
+void AvznCharacter::OnPlayerEnterGrappleState()
+{
+	GrappleRope->SetRopeActive(true);
+}
+
+void AvznCharacter::OnPlayerExitGrappleState()
+{
+	GrappleRope->SetRopeActive(false);
 }
\ No newline at end of file
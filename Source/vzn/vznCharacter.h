@@ -15,6 +15,7 @@ struct FInputActionValue;
 
 class UCustomMovementComponent;
 class UMotionWarpingComponent;
+class UGrappleTargetComponent;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
 
@@ -57,6 +58,12 @@ private:
 	void OnPlayerEnterClimbState();
 	void OnPlayerExitClimbState();
 
+	void OnPlayerEnterSlideState();
+	void OnPlayerExitSlideState();
+
+	void OnPlayerEnterGrappleState();
+	void OnPlayerExitGrappleState();
+
 	void AddInputMappingContext(UInputMappingContext* ContextToAdd, int32 InPriority);
 	void RemoveInputMappingContext(UInputMappingContext* ContextToAdd);
 
@@ -147,15 +154,6 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Crouch, meta = (AllowPrivateAccess = "true"))
 	bool bIsSliding = false;  // Whether the character is currently sliding
 
-	UPROPERTY(EditAnywhere, Category = "Movement")
-	float SlideInitialSpeed = 1500.f;  // Initial speed when starting to slide
-
-	UPROPERTY(EditAnywhere, Category = "Movement")
-	float SlideDeceleration = 500.f;  // How quickly the slide slows down
-
-	UPROPERTY(EditAnywhere, Category = "Movement")
-	float MinSlideSpeed = 500.f;  // Minimum speed before the slide stops
-
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Materials", meta = (AllowPrivateAccess = "true"))
 	UMaterialInstance* DefaultMaterial;
 
@@ -167,17 +165,27 @@ private:
 	void StopInteract();
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Grappling, meta = (AllowPrivateAccess = "true"))
-	class UCableComponent* GrappleCable;
+	class UGrappleRopeComponent* GrappleRope; // Only ticks while grappling
 
 	float MaxLineDistance = 1000.f;
-	bool bIsGrappling = false;
-	FVector GrapplingPoint;
-
-	// Bobbing effect when moving
-	float BobbingSpeed = .5f; // How fast the camera bobs
-	float BobbingAmount = 10.f; // How much the camera bobs
-	float DefaultZ;
-	bool bIsBobbing;
+
+	// Grapple anchors and interactables within this angle of the camera's aim can be targeted
+	UPROPERTY(EditAnywhere, Category = Grappling, meta = (AllowPrivateAccess = "true"))
+	float AimConeHalfAngle = 10.f;
+
+	TWeakObjectPtr<UGrappleTargetComponent> AimTarget; // Highlighted for the local player
+
+	UGrappleTargetComponent* FindAimTarget() const;
+	void InteractWithSweep(); // When no registered target is in the aim cone
+	void UpdateAimTarget();
+
+	// Grapple anchor for simulated proxies to draw the rope to. Set by the movement component on the server
+	UPROPERTY(Replicated)
+	FVector_NetQuantize10 ReplicatedGrappleAnchor = FVector::ZeroVector;
+
+	// Climb surface for simulated proxies, which turn towards it instead of tracing. Set by the movement component on the server
+	UPROPERTY(Replicated)
+	FVector_NetQuantizeNormal ReplicatedClimbSurfaceNormal = FVector::ZeroVector;
 	
 #pragma endregion
 
@@ -190,6 +198,8 @@ protected:
 
 	virtual void Tick(float DeltaTime) override;
 
+	virtual void PawnClientRestart() override;
+
 	// Implementing fall damage/timeout
 	virtual void Landed(const FHitResult& Hit) override;
 
@@ -202,9 +212,30 @@ public:
 	// Custom Movement Component
 	FORCEINLINE UCustomMovementComponent* GetCustomMovementComponent() const { return CustomMovementComponent; }
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	FORCEINLINE const FVector_NetQuantizeNormal& GetReplicatedClimbSurfaceNormal() const { return ReplicatedClimbSurfaceNormal; }
+	void SetReplicatedClimbSurfaceNormal(const FVector& InNormal);
+
+	FORCEINLINE const FVector_NetQuantize10& GetReplicatedGrappleAnchor() const { return ReplicatedGrappleAnchor; }
+	FORCEINLINE void SetReplicatedGrappleAnchor(const FVector& InAnchor) { ReplicatedGrappleAnchor = InAnchor; }
+
 	FORCEINLINE UMotionWarpingComponent* GetMotionWarpingComponent() const { return MotionWarpingComponent; }
 
 	// First Person Camera
 	FORCEINLINE UCameraComponent* GetFirstPersonCamera() const { return FirstPersonCamera; }
 
+#pragma region ScriptedInput
+
+	// Same actions as the input bindings, for driving characters without a player (benchmarks, bots)
+	void ScriptedMove(const FVector2D& InMovement); // Ground or climb movement depending on the state
+	void ScriptedClimb();
+	void ScriptedHop();
+	void ScriptedCrouch(bool bPressed);
+	void ScriptedInteract(bool bPressed);
+	void ScriptedJump(bool bPressed);
+	void ScriptedReset(const FTransform& InStartTransform); // Teleport back to the start, the server picks the start when networked
+
+#pragma endregion
+
 };
\ No newline at end of file